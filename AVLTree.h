@@ -0,0 +1,517 @@
+// Specification file for the AVLTree class
+// It is derived from the abstract base class, BinaryTree class
+// It is a self-balancing binary search tree: after every insert and
+// remove, the heights of the two subtrees of any node differ by at
+// most one, so the tree stays O(log n) deep for any input order,
+// including sorted input and many items with the same key.
+// Like BinarySearchTree, it orders the nodes by the comparison
+// function passed to the constructor. Items that compare equal are
+// ordered by their < operator, so an item is removed by its full key
+// without scanning all the items with the same comparison key.
+// Each node also keeps the total weight of the items of its subtree,
+// ItemWeight<ItemType>::of(item), 1 per item by default, so that the
+// items can be visited from any rank in O(log n) without walking the
+// items before it.
+// AVLTree only stores the pointers to the data object
+
+#ifndef AVL_TREE_H_
+#define AVL_TREE_H_
+
+#include "BinaryTree.h"
+
+// Forward declaration
+template<class ItemType>
+class LinkedList;
+
+// the weight of an item for the ranks of the items in the tree
+// specialize it for items that stand for more than one row
+template<class ItemType>
+struct ItemWeight
+{
+    static long long of(const ItemType&) {return 1;}
+};
+
+template<class ItemType>
+class AVLTree : public BinaryTree<ItemType>
+{
+private:
+    // function pointer
+    // compare two ItemType object function pointer
+    int (*comp)(const ItemType& b1, const ItemType& b2);
+
+public:
+    // constructor
+    // the constructor takes a function pointer which is used
+    // in comparision of two objects for the tree ordering
+    AVLTree(int c(const ItemType& b1, const ItemType& b2)) : BinaryTree<ItemType>() {comp = c;}
+
+    // insert a node at the correct location
+    bool insert(ItemType* dataIn);
+
+    // find a target node
+    bool search(const ItemType& target, ItemType*& dataOut) const;
+
+    // find a list of nodes that matched target node
+    bool search(const ItemType& target, LinkedList<ItemType>& dataList);
+
+    // remove a node if found
+    bool remove(const ItemType& target, ItemType*& dataOut);
+
+    // height of the tree, 0 if empty
+    int getHeight() const {return height(this->rootPtr);}
+
+    // total weight of the items, the number of items by default
+    long long getWeight() const {return weight(this->rootPtr);}
+
+    // recompute the weights on the path to the item with the lookup
+    // key, after the weight of that item changed
+    // keyComp(item, key) orders the items like the compare function
+    template<class Key, class KeyCompare>
+    void reweigh(const Key& key, KeyCompare keyComp);
+
+    // visit the items in order from the item at the given rank
+    // (the sum of the weights of the items before it)
+    // visit(item, offset) gets the offset of the rank in the first
+    // item, 0 for the others, and returns false to stop the walk
+    template<class Visit>
+    void inOrderFrom(long long rank, Visit visit) const;
+
+private:
+    // order of two items: by the comparison function, then by <
+    int order(const ItemType& b1, const ItemType& b2) const;
+
+    // internal insert node: insert newNode in nodePtr subtree
+    BinaryNode<ItemType>* _insert(BinaryNode<ItemType>* nodePtr, BinaryNode<ItemType>* newNode);
+
+    // search for a list of nodes that matched target node in treePtr subtree
+    void _search(BinaryNode<ItemType>* treePtr, const ItemType& target,
+                 LinkedList<ItemType>& dataList) const;
+
+    // internal remove node: locate and unlink target node in nodePtr subtree
+    BinaryNode<ItemType>* _remove(BinaryNode<ItemType>* nodePtr, const ItemType& target,
+                                  BinaryNode<ItemType>*& targetNodePtr);
+
+    // unlink the leftmost node in the subtree of nodePtr (smallest)
+    BinaryNode<ItemType>* _removeLeftmostNode(BinaryNode<ItemType>* nodePtr,
+                                              BinaryNode<ItemType>*& leftmost);
+
+    // recompute the weights on the path to the key in nodePtr subtree
+    template<class Key, class KeyCompare>
+    void _reweigh(BinaryNode<ItemType>* nodePtr, const Key& key, KeyCompare keyComp);
+
+    // visit the items of nodePtr subtree from rank, rank is 0 after
+    // the first item visited; return false if the walk was stopped
+    template<class Visit>
+    bool _inorderFrom(BinaryNode<ItemType>* nodePtr, long long& rank, Visit& visit) const;
+
+    // height, weight and balance helpers
+    static int height(const BinaryNode<ItemType>* nodePtr) {return nodePtr ? nodePtr->getHeight() : 0;}
+    static long long weight(const BinaryNode<ItemType>* nodePtr) {return nodePtr ? nodePtr->getWeight() : 0;}
+    static void updateHeight(BinaryNode<ItemType>* nodePtr);
+    static BinaryNode<ItemType>* rotateLeft(BinaryNode<ItemType>* nodePtr);
+    static BinaryNode<ItemType>* rotateRight(BinaryNode<ItemType>* nodePtr);
+    static BinaryNode<ItemType>* balance(BinaryNode<ItemType>* nodePtr);
+};
+
+//**************************************************
+// Insert a node at the correct location
+// - input param: the pointer to the data to be inserted
+// - return true
+//**************************************************
+template<class ItemType>
+bool AVLTree<ItemType>::insert(ItemType* dataIn)
+{
+    BinaryNode<ItemType>* newNodePtr = new BinaryNode<ItemType>(dataIn);
+    newNodePtr->setWeight(ItemWeight<ItemType>::of(*dataIn));
+    this->rootPtr = _insert(this->rootPtr, newNodePtr);
+    this->count++;
+    return true;
+}
+
+//**************************************************
+// Find a target node
+// - input param: target data, only the comparison key is used
+// - if found, it sends the data of a matching node back to the
+//   caller via the output parameter, and returns true,
+//   otherwise it returns false.
+//**************************************************
+template<class ItemType>
+bool AVLTree<ItemType>::search(const ItemType& target, ItemType*& dataOut) const
+{
+    BinaryNode<ItemType>* nodePtr = this->rootPtr;
+    while (nodePtr) {
+        int c = comp(*nodePtr->getItem(), target);
+        if (c == 0) {
+            dataOut = nodePtr->getItem();
+            return true;
+        }
+        nodePtr = (c > 0) ? nodePtr->getLeftPtr() : nodePtr->getRightPtr();
+    }
+    return false;
+}
+
+//**************************************************
+// Find a list of nodes that matched target node
+// - input param: target data, only the comparison key is used
+// - return true if found, otherwise, false
+//   return a list of nodes that matched the target
+//   in the output parameter
+//**************************************************
+template<class ItemType>
+bool AVLTree<ItemType>::search(const ItemType& target, LinkedList<ItemType>& dataList)
+{
+    _search(this->rootPtr, target, dataList);
+    if (dataList.getLength()) {
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+//**************************************************
+// Remove a node if found
+// - input param: target data, matched by the comparison
+//                key and then by ==
+// - return true if found, otherwise false
+//   return the data found via output parameter
+//**************************************************
+template<class ItemType>
+bool AVLTree<ItemType>::remove(const ItemType& target, ItemType*& dataOut)
+{
+    BinaryNode<ItemType>* targetNodePtr = nullptr;
+    this->rootPtr = _remove(this->rootPtr, target, targetNodePtr);
+    if (targetNodePtr) {
+        dataOut = targetNodePtr->getItem();
+        // delete the actual memory of the node
+        delete targetNodePtr;
+        this->count--;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+//**************************************************
+// Order of two items
+// - return < 0, 0 or > 0 if b1 is before, the same as,
+//   or after b2: by the comparison function first,
+//   then by the < operator of the items
+//**************************************************
+template<class ItemType>
+int AVLTree<ItemType>::order(const ItemType& b1, const ItemType& b2) const
+{
+    int c = comp(b1, b2);
+    if (c != 0) {
+        return c;
+    }
+    if (b1 < b2) {
+        return -1;
+    }
+    return (b2 < b1) ? 1 : 0;
+}
+
+//**************************************************
+// Implementation of the insert operation: recursive
+// Insert newNode in nodePtr subtree and rebalance
+// the nodes on the way back up
+// - input params: pointer to the node of the substree to insert
+//                 pointer to the node to be inserted
+// - return the new root of the substree
+//**************************************************
+template<class ItemType>
+BinaryNode<ItemType>* AVLTree<ItemType>::_insert(BinaryNode<ItemType>* nodePtr,
+                                                 BinaryNode<ItemType>* newNodePtr)
+{
+    if (!nodePtr) // == NULL
+    {
+        return newNodePtr;
+    }
+
+    if (order(*nodePtr->getItem(), *newNodePtr->getItem()) > 0) {
+        nodePtr->setLeftPtr(_insert(nodePtr->getLeftPtr(), newNodePtr));
+    }
+    else {
+        nodePtr->setRightPtr(_insert(nodePtr->getRightPtr(), newNodePtr));
+    }
+
+    return balance(nodePtr);
+}
+
+//**************************************************
+// Implementation of the search operation: recursive
+// Matching items can be in both subtrees of a matching node,
+// so both are searched; other subtrees are skipped
+// - input params: pointer to the node of the substree to search
+//                 target data
+// - return a list of nodes that matched the target
+//   in the output parameter
+//**************************************************
+template<class ItemType>
+void AVLTree<ItemType>::_search(BinaryNode<ItemType>* nodePtr, const ItemType& target,
+                                LinkedList<ItemType>& dataList) const
+{
+    if (!nodePtr) // == NULL
+    {
+        return;
+    }
+
+    ItemType* item = nodePtr->getItem();
+    int c = comp(*item, target);
+
+    if (c >= 0) {
+        _search(nodePtr->getLeftPtr(), target, dataList);
+    }
+    if (c == 0) {
+        // target node found
+        dataList.insertNode(item);
+    }
+    if (c <= 0) {
+        _search(nodePtr->getRightPtr(), target, dataList);
+    }
+}
+
+//**************************************************
+// Implementation of the delete operation: recursive
+// The target node is replaced by the leftmost node of its right
+// subtree, and the nodes on the way back up are rebalanced
+// - input params: pointer to the node of the substree to
+//                 search for removing target node
+// - return the new root of the substree
+//   return a pointer to the node that matched the target
+//          to remove via output parameter
+//**************************************************
+template<class ItemType>
+BinaryNode<ItemType>* AVLTree<ItemType>::_remove(BinaryNode<ItemType>* nodePtr,
+                                                 const ItemType& target,
+                                                 BinaryNode<ItemType>*& targetNodePtr)
+{
+    if (!nodePtr) // == NULL
+    {
+        return nullptr;
+    }
+
+    ItemType* item = nodePtr->getItem();
+
+    if (*item == target) {
+        // target node found
+        targetNodePtr = nodePtr;
+
+        BinaryNode<ItemType>* left = nodePtr->getLeftPtr();
+        BinaryNode<ItemType>* right = nodePtr->getRightPtr();
+        if (!left || !right) {
+            // zero or one child: the child replaces the node
+            return left ? left : right;
+        }
+
+        // two children: the smallest node of the right subtree replaces the node
+        BinaryNode<ItemType>* leftmost = nullptr;
+        right = _removeLeftmostNode(right, leftmost);
+        leftmost->setLeftPtr(left);
+        leftmost->setRightPtr(right);
+        return balance(leftmost);
+    }
+
+    if (order(*item, target) > 0) {
+        nodePtr->setLeftPtr(_remove(nodePtr->getLeftPtr(), target, targetNodePtr));
+    }
+    else {
+        nodePtr->setRightPtr(_remove(nodePtr->getRightPtr(), target, targetNodePtr));
+    }
+
+    return balance(nodePtr);
+}
+
+//**************************************************
+// unlink the leftmost node in the subtree of nodePtr (smallest)
+// and rebalance the nodes on the way back up
+// - input param: the pointer to the node of the substree
+// - return the new root of the substree
+//   return the leftmost node via output parameter
+//**************************************************
+template<class ItemType>
+BinaryNode<ItemType>* AVLTree<ItemType>::_removeLeftmostNode(BinaryNode<ItemType>* nodePtr,
+                                                             BinaryNode<ItemType>*& leftmost)
+{
+    if (nodePtr->getLeftPtr() == nullptr) {
+        // current node does not have a left child, it is the leftmost node
+        leftmost = nodePtr;
+        return nodePtr->getRightPtr();
+    }
+
+    nodePtr->setLeftPtr(_removeLeftmostNode(nodePtr->getLeftPtr(), leftmost));
+    return balance(nodePtr);
+}
+
+//**************************************************
+// Recompute the weights on the path to an item
+// - input params: the lookup key of the item, and the
+//                 function comparing an item with the key
+//**************************************************
+template<class ItemType>
+template<class Key, class KeyCompare>
+void AVLTree<ItemType>::reweigh(const Key& key, KeyCompare keyComp)
+{
+    _reweigh(this->rootPtr, key, keyComp);
+}
+
+//**************************************************
+// Visit the items in order from a rank
+// - input params: the rank of the first item to visit, and the
+//                 function called with each item and the offset
+//                 of the rank in it, which returns false to stop
+//**************************************************
+template<class ItemType>
+template<class Visit>
+void AVLTree<ItemType>::inOrderFrom(long long rank, Visit visit) const
+{
+    if (rank < 0) {
+        rank = 0;
+    }
+    _inorderFrom(this->rootPtr, rank, visit);
+}
+
+//**************************************************
+// Implementation of the reweigh operation: recursive
+// The weights are recomputed on the way back up
+// - input params: pointer to the node of the substree,
+//                 the lookup key and its compare function
+//**************************************************
+template<class ItemType>
+template<class Key, class KeyCompare>
+void AVLTree<ItemType>::_reweigh(BinaryNode<ItemType>* nodePtr, const Key& key, KeyCompare keyComp)
+{
+    if (!nodePtr) // == NULL
+    {
+        return;
+    }
+
+    int c = keyComp(*nodePtr->getItem(), key);
+    if (c > 0) {
+        _reweigh(nodePtr->getLeftPtr(), key, keyComp);
+    }
+    else if (c < 0) {
+        _reweigh(nodePtr->getRightPtr(), key, keyComp);
+    }
+    updateHeight(nodePtr);
+}
+
+//**************************************************
+// Implementation of the ranked inorder traversal: recursive
+// A subtree that ends before the rank is skipped by its weight,
+// so only the path to the first item is walked before visiting
+// - input params: pointer to the node of the substree, the rank
+//                 to start from in the subtree, and the visit function
+// - return false if the visit function stopped the walk
+//**************************************************
+template<class ItemType>
+template<class Visit>
+bool AVLTree<ItemType>::_inorderFrom(BinaryNode<ItemType>* nodePtr, long long& rank,
+                                     Visit& visit) const
+{
+    if (!nodePtr) // == NULL
+    {
+        return true;
+    }
+
+    long long wl = weight(nodePtr->getLeftPtr());
+    if (rank < wl) {
+        if (!_inorderFrom(nodePtr->getLeftPtr(), rank, visit)) {
+            return false;
+        }
+    }
+    else {
+        rank -= wl;
+    }
+
+    ItemType* item = nodePtr->getItem();
+    long long w = ItemWeight<ItemType>::of(*item);
+    if (rank < w) {
+        if (!visit(*item, rank)) {
+            return false;
+        }
+        rank = 0;
+    }
+    else {
+        rank -= w;
+    }
+
+    return _inorderFrom(nodePtr->getRightPtr(), rank, visit);
+}
+
+//**************************************************
+// recompute the height and the weight of a node from its children
+//**************************************************
+template<class ItemType>
+void AVLTree<ItemType>::updateHeight(BinaryNode<ItemType>* nodePtr)
+{
+    int hl = height(nodePtr->getLeftPtr());
+    int hr = height(nodePtr->getRightPtr());
+    nodePtr->setHeight((hl > hr ? hl : hr) + 1);
+    nodePtr->setWeight(weight(nodePtr->getLeftPtr()) + weight(nodePtr->getRightPtr()) +
+                       ItemWeight<ItemType>::of(*nodePtr->getItem()));
+}
+
+//**************************************************
+// rotate a subtree left: the right child becomes its root
+// - return the new root of the subtree
+//**************************************************
+template<class ItemType>
+BinaryNode<ItemType>* AVLTree<ItemType>::rotateLeft(BinaryNode<ItemType>* nodePtr)
+{
+    BinaryNode<ItemType>* right = nodePtr->getRightPtr();
+    nodePtr->setRightPtr(right->getLeftPtr());
+    right->setLeftPtr(nodePtr);
+    updateHeight(nodePtr);
+    updateHeight(right);
+    return right;
+}
+
+//**************************************************
+// rotate a subtree right: the left child becomes its root
+// - return the new root of the subtree
+//**************************************************
+template<class ItemType>
+BinaryNode<ItemType>* AVLTree<ItemType>::rotateRight(BinaryNode<ItemType>* nodePtr)
+{
+    BinaryNode<ItemType>* left = nodePtr->getLeftPtr();
+    nodePtr->setLeftPtr(left->getRightPtr());
+    left->setRightPtr(nodePtr);
+    updateHeight(nodePtr);
+    updateHeight(left);
+    return left;
+}
+
+//**************************************************
+// restore the AVL balance of a node whose subtrees
+// differ in height by at most two
+// - return the new root of the subtree
+//**************************************************
+template<class ItemType>
+BinaryNode<ItemType>* AVLTree<ItemType>::balance(BinaryNode<ItemType>* nodePtr)
+{
+    updateHeight(nodePtr);
+    int diff = height(nodePtr->getLeftPtr()) - height(nodePtr->getRightPtr());
+
+    if (diff > 1) {
+        // left heavy
+        BinaryNode<ItemType>* left = nodePtr->getLeftPtr();
+        if (height(left->getLeftPtr()) < height(left->getRightPtr())) {
+            nodePtr->setLeftPtr(rotateLeft(left));
+        }
+        return rotateRight(nodePtr);
+    }
+    if (diff < -1) {
+        // right heavy
+        BinaryNode<ItemType>* right = nodePtr->getRightPtr();
+        if (height(right->getRightPtr()) < height(right->getLeftPtr())) {
+            nodePtr->setRightPtr(rotateRight(right));
+        }
+        return rotateLeft(nodePtr);
+    }
+
+    return nodePtr;
+}
+
+#endif // AVL_TREE_H_
@@ -0,0 +1,97 @@
+// Implementation file for the allocation counter
+
+#include <cstdlib>
+#include <atomic>
+#include <new>
+using namespace std;
+
+#include "AllocCount.h"
+
+// number of calls to operator new while counting
+static atomic<long long> allocCount(0);
+
+// true while the calls are counted
+static atomic<bool> counting(false);
+
+//**************************************************
+// turn counting the calls to operator new on or off
+//**************************************************
+void setAllocCounting(bool on)
+{
+    counting.store(on, memory_order_relaxed);
+}
+
+//**************************************************
+// return the number of calls to operator new
+// made while counting was on
+//**************************************************
+long long getAllocCount()
+{
+    return allocCount.load(memory_order_relaxed);
+}
+
+//**************************************************
+// global operator new: counts the allocation if counting is on
+//**************************************************
+void* operator new(size_t size)
+{
+    if (counting.load(memory_order_relaxed)) {
+        allocCount.fetch_add(1, memory_order_relaxed);
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+    if (counting.load(memory_order_relaxed)) {
+        allocCount.fetch_add(1, memory_order_relaxed);
+    }
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+//**************************************************
+// global operator delete
+//**************************************************
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, const nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, const nothrow_t&) noexcept
+{
+    free(p);
+}
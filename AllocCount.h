@@ -0,0 +1,18 @@
+// Specification file for the allocation counter
+// AllocCount.cpp replaces the global operator new and delete
+// with versions that count the calls to operator new, so the
+// benchmarks can report the allocations per operation.
+// Counting is off unless a benchmark turns it on: the other
+// allocations only read a flag, and do not increment a counter
+// shared by all the threads.
+
+#ifndef ALLOC_COUNT_H_
+#define ALLOC_COUNT_H_
+
+// turn counting the calls to operator new on or off
+void setAllocCounting(bool on);
+
+// the number of calls to operator new made while counting was on
+long long getAllocCount();
+
+#endif // ALLOC_COUNT_H_
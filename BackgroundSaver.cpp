@@ -0,0 +1,288 @@
+// Implementation file for the BackgroundSaver class
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+using namespace std;
+
+#include "Stock.h"
+#include "Snapshot.h"
+#include "Utils.h"
+#include "ThreadPool.h"
+#include "BackgroundSaver.h"
+
+// the text file is formatted in chunks of this many stocks, one
+// chunk per thread at a time, and the progress is updated after
+// the chunks are written
+static const size_t CHUNK_SIZE = 1 << 14;
+
+// the stocks are sorted on one thread below this many
+static const size_t MIN_PARALLEL_SORT = 1 << 16;
+
+//**************************************************
+// the key order: by symbol + date
+//**************************************************
+static bool lessKey(const Stock* s1, const Stock* s2)
+{
+    return *s1 < *s2;
+}
+
+//**************************************************
+// the company order: by company, then symbol + date
+//**************************************************
+static bool lessCompany(const Stock* s1, const Stock* s2)
+{
+    int c = s1->getCompanyName().compare(s2->getCompanyName());
+    return c < 0 || (c == 0 && *s1 < *s2);
+}
+
+//**************************************************
+// Constructor
+//**************************************************
+BackgroundSaver::BackgroundSaver()
+{
+    state = IDLE;
+    numSaved = 0;
+    numBytes = 0;
+    elapsed = 0;
+    order = KEY_ORDER;
+    numThreads = 1;
+}
+
+//**************************************************
+// Destructor
+//**************************************************
+BackgroundSaver::~BackgroundSaver()
+{
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+//**************************************************
+// start saving stocks on the background thread
+// - input params: the text file and the snapshot file to
+//                 write, and the stocks to save
+// - return false if a save is already in progress
+//**************************************************
+bool BackgroundSaver::start(const string& textFile, const string& snapFile, vector<Stock*>& stocks)
+{
+    if (state != IDLE) {
+        return false;
+    }
+    this->textFile = textFile;
+    this->snapFile = snapFile;
+    this->stocks.swap(stocks);
+    stocks.clear();
+    error.clear();
+    numSaved = 0;
+    numBytes = 0;
+    elapsed = 0;
+    startTime = chrono::steady_clock::now();
+    state = RUNNING;
+
+    worker = thread(&BackgroundSaver::run, this);
+    return true;
+}
+
+//**************************************************
+// wait for the save to end and report it
+// - input param: the stream to report to
+// - return true if both files were saved
+//**************************************************
+bool BackgroundSaver::finish(ostream& os)
+{
+    if (state == IDLE) {
+        return false;
+    }
+    worker.join();
+
+    bool ok = state == DONE;
+    if (ok) {
+        double secs = elapsed;
+        os << "Saved Stock database to " << textFile << " and " << snapFile << endl;
+        os << fixed << setprecision(2) << "  " << numSaved << " stocks, "
+           << numBytes / 1048576.0 << " MB in " << secs << " s, "
+           << (secs > 0 ? numBytes / 1048576.0 / secs : 0) << " MB/s" << endl;
+    }
+    else {
+        os << "Error saving Stock database: " << error << endl;
+    }
+
+    vector<Stock*>().swap(stocks);
+    state = IDLE;
+    return ok;
+}
+
+//**************************************************
+// report the progress of the save in progress
+// - input param: the stream to report to
+//**************************************************
+void BackgroundSaver::showProgress(ostream& os) const
+{
+    if (state == IDLE) {
+        os << "No save in progress" << endl;
+        return;
+    }
+    if (isOver()) {
+        os << "The save to " << textFile << " is over" << endl;
+        return;
+    }
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    long long saved = numSaved;
+    long long bytes = numBytes;
+    long long total = static_cast<long long>(stocks.size());
+    os << fixed << setprecision(2) << "Saving to " << textFile << ": "
+       << (total > 0 ? 100.0 * saved / total : 100.0) << "% ("
+       << saved << " of " << total << " stocks), "
+       << bytes / 1048576.0 << " MB in " << secs << " s, "
+       << (secs > 0 ? bytes / 1048576.0 / secs : 0) << " MB/s" << endl;
+}
+
+//**************************************************
+// thread function: sort the stocks, write the text file,
+// then the snapshot in the same order
+//**************************************************
+void BackgroundSaver::run()
+{
+    int n = numThreads > 0 ? numThreads : ThreadPool::hardwareThreads();
+    ThreadPool* pool = NULL;
+    if (n > 1) {
+        pool = new ThreadPool(n);
+    }
+
+    sortStocks(pool);
+    bool ok = saveText(pool);
+    delete pool;
+    if (ok) {
+        ok = saveSnapshot(snapFile, stocks);
+        if (ok) {
+            ifstream inFile(snapFile, ios::binary | ios::ate);
+            numBytes += static_cast<long long>(inFile.tellg());
+        }
+        else {
+            error = "cannot write " + snapFile;
+        }
+    }
+
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    state = ok ? DONE : FAILED;
+}
+
+//**************************************************
+// sort the stocks in the save order
+// Each thread sorts a run of the stocks, then adjacent runs
+// are merged in pairs, the pairs of one round in parallel,
+// until one run is left. Both orders are total orders (the
+// key is unique), so the result does not depend on the runs
+// - input param: the thread pool, or NULL to sort on this thread
+//**************************************************
+void BackgroundSaver::sortStocks(ThreadPool* pool)
+{
+    if (order == HASH_ORDER) {
+        return;
+    }
+    bool (*less)(const Stock*, const Stock*) = order == KEY_ORDER ? lessKey : lessCompany;
+    vector<Stock*>::iterator first = stocks.begin();
+    size_t n = stocks.size();
+    if (!pool || n < MIN_PARALLEL_SORT) {
+        sort(first, stocks.end(), less);
+        return;
+    }
+
+    // the bounds of the runs
+    int numRuns = pool->getSize();
+    vector<size_t> bounds(numRuns + 1);
+    for (int i = 0; i <= numRuns; i++) {
+        bounds[i] = n * i / numRuns;
+    }
+
+    for (int i = 0; i < numRuns; i++) {
+        size_t lo = bounds[i], hi = bounds[i + 1];
+        pool->submit([=]() {sort(first + lo, first + hi, less);});
+    }
+    pool->wait();
+
+    for (int width = 1; width < numRuns; width *= 2) {
+        for (int i = 0; i + width < numRuns; i += 2 * width) {
+            size_t lo = bounds[i], mid = bounds[i + width];
+            size_t hi = bounds[min(i + 2 * width, numRuns)];
+            pool->submit([=]() {inplace_merge(first + lo, first + mid, first + hi, less);});
+        }
+        pool->wait();
+    }
+}
+
+//**************************************************
+// write the stocks to the text file, in the DB file line
+// format, through a temporary file renamed when complete
+// Each thread formats a chunk of stocks into its own buffer
+// and the buffers are written in order
+// - input param: the thread pool, or NULL to format on this thread
+// - return true if successful, otherwise, false
+//**************************************************
+bool BackgroundSaver::saveText(ThreadPool* pool)
+{
+    string tmpFile = textFile + ".tmp";
+    ofstream outFile(tmpFile, ios::binary | ios::trunc);
+    if (outFile.fail()) {
+        error = "cannot open " + tmpFile;
+        return false;
+    }
+
+    size_t n = stocks.size();
+    int width = pool ? pool->getSize() : 1;
+    vector<string> blocks(width);
+    for (size_t first = 0; first < n; first += CHUNK_SIZE * width) {
+        for (int t = 0; t < width; t++) {
+            size_t lo = min(n, first + CHUNK_SIZE * t);
+            size_t hi = min(n, lo + CHUNK_SIZE);
+            string* block = &blocks[t];
+            const vector<Stock*>* all = &stocks;
+            function<void()> format = [block, all, lo, hi]() {
+                block->clear();
+                for (size_t i = lo; i < hi; i++) {
+                    appendStockLine(*block, *(*all)[i]);
+                    *block += '\n';
+                }
+            };
+            if (pool) {
+                pool->submit(format);
+            }
+            else {
+                format();
+            }
+        }
+        if (pool) {
+            pool->wait();
+        }
+
+        for (int t = 0; t < width; t++) {
+            outFile.write(blocks[t].data(), blocks[t].size());
+            numBytes += static_cast<long long>(blocks[t].size());
+        }
+        numSaved = static_cast<long long>(min(n, first + CHUNK_SIZE * width));
+    }
+    outFile.close();
+
+    if (outFile.fail() || !syncFile(tmpFile)) {
+        error = "cannot write " + tmpFile;
+        remove(tmpFile.c_str());
+        return false;
+    }
+    if (rename(tmpFile.c_str(), textFile.c_str()) != 0) {
+        error = "cannot rename " + tmpFile + " to " + textFile;
+        remove(tmpFile.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,107 @@
+// Specification file for the BackgroundSaver class
+// BackgroundSaver writes the DB text file and its binary snapshot
+// on a background thread, so the menu and the writers keep running
+// while the DB is saved. The caller hands it the list of the stocks
+// at one point in time: the Stock objects are never changed while
+// they are in the DB and are only freed with the whole DB, so the
+// list is a consistent snapshot as long as the DB is not freed
+// before the save is finished.
+// Each file is written to a temporary file, flushed to the disk
+// and renamed over the old file, so a crash while saving leaves
+// the previous copy intact.
+// The stocks are saved sorted by their unique key (symbol + date) or
+// by company name then key, so the same data always gives the same
+// files whatever the hash table history; the sorted runs and the
+// merges, and the formatting of the text, are spread over a thread
+// pool. The hash table order is kept as the fastest, unsorted option.
+
+#ifndef BACKGROUND_SAVER_H_
+#define BACKGROUND_SAVER_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <iostream>
+using std::string;
+using std::vector;
+using std::ostream;
+
+// Forward Declaration
+class Stock;
+
+class ThreadPool;
+
+class BackgroundSaver
+{
+public:
+    // the state of the saver
+    enum State {IDLE, RUNNING, DONE, FAILED};
+
+    // the order of the stocks in the saved files
+    enum Order {HASH_ORDER, KEY_ORDER, COMPANY_ORDER};
+
+private:
+    std::thread worker;
+    vector<Stock*> stocks;              // the stocks to save
+    string textFile;                    // the text file to write
+    string snapFile;                    // the snapshot file to write
+    string error;                       // why the save failed
+    Order order;                        // the order of the stocks
+    int numThreads;                     // threads to sort and format on
+    std::atomic<int> state;
+    std::atomic<long long> numSaved;    // stocks written to the text file
+    std::atomic<long long> numBytes;    // bytes written to both files
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<double> elapsed;        // seconds, once the save is over
+
+public:
+    // constructor and destructor, the destructor waits
+    // for a save in progress
+    BackgroundSaver();
+    ~BackgroundSaver();
+
+    // setters, for the next save
+    void setOrder(Order order) {this->order = order;}
+    void setNumThreads(int n) {numThreads = n;}
+
+    // getters
+    Order getOrder() const {return order;}
+    int getNumThreads() const {return numThreads;}
+    State getState() const {return static_cast<State>(state.load());}
+    bool isRunning() const {return state.load() == RUNNING;}
+    bool isOver() const {return state.load() == DONE || state.load() == FAILED;}
+    const string& getTextFile() const {return textFile;}
+    const string& getSnapFile() const {return snapFile;}
+
+    // start saving the stocks to the text file and the snapshot,
+    // the stocks are moved out of the vector
+    // return false if a save is already in progress
+    bool start(const string& textFile, const string& snapFile, vector<Stock*>& stocks);
+
+    // wait for the save to end and report it
+    // return true if both files were saved, false if the
+    // save failed or there was no save to wait for
+    bool finish(ostream& os);
+
+    // report the progress of the save in progress
+    void showProgress(ostream& os) const;
+
+private:
+    // thread function: write both files
+    void run();
+
+    // sort the stocks in the save order, on the pool if not NULL
+    void sortStocks(ThreadPool* pool);
+
+    // write the text file, one stock per line,
+    // formatted on the pool if not NULL
+    bool saveText(ThreadPool* pool);
+
+    // not copyable
+    BackgroundSaver(const BackgroundSaver&);
+    BackgroundSaver& operator=(const BackgroundSaver&);
+};
+
+#endif // BACKGROUND_SAVER_H_
@@ -0,0 +1,404 @@
+// Implementation file for the BatchRunner class
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+#include "Stock.h"
+#include "StockDB.h"
+#include "Screener.h"
+#include "TopStocks.h"
+#include "SymbolIndex.h"
+#include "Utils.h"
+#include "BatchRunner.h"
+
+//**************************************************
+// Constructor
+//**************************************************
+BatchRunner::BatchRunner(StockDB& db, ostream& out) : db(db), out(out)
+{
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        stats[i].count = 0;
+        stats[i].errors = 0;
+        stats[i].totalSecs = 0;
+        stats[i].maxLatency = 0;
+    }
+    numCommands = 0;
+    seed = 0x9e3779b97f4a7c15ULL;
+}
+
+//**************************************************
+// the name of a command, as written in the script
+//**************************************************
+const char* BatchRunner::getCommandName(Command cmd)
+{
+    static const char* names[NUM_COMMANDS] = {
+        "add", "get", "company", "range", "del", "delcompany", "undo", "screen",
+        "save", "count", "table", "mget", "gainers", "losers", "volume",
+        "indicators"
+    };
+    return names[cmd];
+}
+
+//**************************************************
+// the command of a name
+// - return NUM_COMMANDS if there is no command with the name
+//**************************************************
+BatchRunner::Command BatchRunner::findCommand(const string& name)
+{
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        if (name == getCommandName(static_cast<Command>(i))) {
+            return static_cast<Command>(i);
+        }
+    }
+    return NUM_COMMANDS;
+}
+
+//**************************************************
+// run the commands of a script file
+// - input param: the script filename
+// - return false if the file cannot be opened
+//**************************************************
+bool BatchRunner::runFile(const string& filename)
+{
+    ifstream inFile(filename);
+    if (!inFile) {
+        cout << "Error opening the script file: \"" << filename << "\"" << endl;
+        return false;
+    }
+
+    string line;
+    int lineNo = 0;
+    while (getline(inFile, line)) {
+        lineNo++;
+        runCommand(line, lineNo);
+    }
+    flush();
+    return true;
+}
+
+//**************************************************
+// run one command line and buffer its result
+// - input params: the command line, and its line number
+// - return false if the command failed
+//**************************************************
+bool BatchRunner::runCommand(const string& line, int lineNo)
+{
+    bool ok = runCommand(line, lineNo, buffer);
+    if (buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+    return ok;
+}
+
+//**************************************************
+// run one command line and append its result
+// Only the StockDB call is timed, not the parsing
+// of the line or the writing of the result
+// - input params: the command line, its line number,
+//                 and the string to append the result to
+// - return false if the command failed
+//**************************************************
+bool BatchRunner::runCommand(const string& line, int lineNo, string& output)
+{
+    string text = trim(line);
+    if (text.empty() || text[0] == '#') {
+        return true;
+    }
+
+    size_t sp = text.find(' ');
+    string name = text.substr(0, sp);
+    string args = sp == string::npos ? "" : trim(text.substr(sp + 1));
+    Command cmd = findCommand(name);
+    if (cmd == NUM_COMMANDS) {
+        output += "ERR " + name + " unknown command at line " + to_string(lineNo) + "\n";
+        return false;
+    }
+
+    vector<Stock*> result;
+    string lines, error;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool ok = execute(cmd, args, lineNo, result, lines, error);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    CommandStats& s = stats[cmd];
+    addLatency(s, secs * 1e6);
+    s.totalSecs += secs;
+    numCommands++;
+
+    if (!ok) {
+        s.errors++;
+        output += "ERR ";
+        output += name;
+        output += ' ';
+        output += error;
+        output += '\n';
+    }
+    else {
+        output += "OK ";
+        output += name;
+        output += ' ';
+        output += to_string(result.size() + std::count(lines.begin(), lines.end(), '\n'));
+        output += '\n';
+        output += lines;
+        for (size_t i = 0; i < result.size(); i++) {
+            appendStockLine(output, *result[i]);
+            output += '\n';
+        }
+    }
+    return ok;
+}
+
+//**************************************************
+// record the latency of a run of a command
+// The first MAX_SAMPLES latencies are all kept, then each
+// run replaces a random kept latency with the probability
+// MAX_SAMPLES / runs (reservoir sampling), so the kept ones
+// are a uniform sample of all the runs
+// - input params: the stats of the command, and the latency
+//**************************************************
+void BatchRunner::addLatency(CommandStats& s, double us)
+{
+    s.count++;
+    s.maxLatency = max(s.maxLatency, us);
+    if (s.latencies.size() < MAX_SAMPLES) {
+        s.latencies.push_back(us);
+        return;
+    }
+
+    // xorshift64
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    uint64_t i = seed % static_cast<uint64_t>(s.count);
+    if (i < MAX_SAMPLES) {
+        s.latencies[i] = us;
+    }
+}
+
+//**************************************************
+// run a parsed command
+// - input params: the command, its arguments, and its line number
+// - return true if successful, otherwise, false and the reason
+//   via output parameter; the stocks of the result, or the
+//   lines of a result that is not stocks, via output parameters
+//**************************************************
+bool BatchRunner::execute(Command cmd, const string& args, int lineNo,
+                          vector<Stock*>& result, string& lines, string& error)
+{
+    istringstream in(args);
+    string symbol, date, toDate;
+
+    switch (cmd) {
+    case ADD: {
+        ostringstream os;
+        Stock* stk = db.addStock(args, lineNo, os);
+        if (!stk) {
+            error = os.str().empty() ? "symbol and date already exist" : trim(os.str());
+            return false;
+        }
+        result.push_back(stk);
+        break;
+    }
+    case GET:
+    case DELETE: {
+        if (!(in >> symbol >> date)) {
+            error = "symbol and date are needed";
+            return false;
+        }
+        Stock* stk = cmd == GET ? db.searchSymbol(symbol, date) : db.deleteSymbol(symbol, date);
+        if (stk) {
+            result.push_back(stk);
+        }
+        break;
+    }
+    case COMPANY: {
+        const vector<Stock*>* stocks = db.searchCompany(args);
+        if (stocks) {
+            result = *stocks;
+        }
+        break;
+    }
+    case RANGE:
+        if (!(in >> symbol >> date >> toDate)) {
+            error = "symbol and two dates are needed";
+            return false;
+        }
+        if (db.searchRange(symbol, date, toDate, result) < 0) {
+            error = "invalid date";
+            return false;
+        }
+        break;
+    case DELCOMPANY:
+        db.deleteCompany(args, result);
+        break;
+    case UNDO: {
+        Stock* stk = db.undoLastDelete();
+        if (!stk) {
+            error = "no deletion to undo, or the stock was added again";
+            return false;
+        }
+        result.push_back(stk);
+        break;
+    }
+    case SCREEN: {
+        Screener screener;
+        if (!screener.parse(args, error)) {
+            return false;
+        }
+        db.screenStocks(screener, result);
+        break;
+    }
+    case SAVE: {
+        ostringstream os;
+        if (!db.saveDB(args.empty() ? db.getDBFile() : args, os)) {
+            error = "cannot save the database";
+            return false;
+        }
+        break;
+    }
+    case COUNT:
+        lines = to_string(db.getNumStocks()) + "\n";
+        break;
+    case TABLE: {
+        long long offset = 0;
+        int limit = db.getNumStocks();
+        if (!args.empty() && !(in >> offset && (in.eof() || in >> limit))) {
+            error = "offset and limit must be numbers";
+            return false;
+        }
+        if (offset < 0 || limit < 0) {
+            error = "offset and limit must not be negative";
+            return false;
+        }
+        db.getSortedStocks(offset, limit, result);
+        break;
+    }
+    case MGET: {
+        // the keys refer to the strings, which must not move
+        vector<string> words;
+        string word;
+        while (in >> word) {
+            words.push_back(word);
+        }
+        if (words.empty() || words.size() % 2 != 0) {
+            error = "pairs of symbol and date are needed";
+            return false;
+        }
+        vector<StockKey> keys;
+        keys.reserve(words.size() / 2);
+        for (size_t i = 0; i < words.size(); i += 2) {
+            keys.push_back(StockKey(words[i], words[i + 1]));
+        }
+        vector<Stock*> found;
+        db.searchSymbols(keys, found);
+        for (size_t i = 0; i < found.size(); i++) {
+            if (found[i]) {
+                result.push_back(found[i]);
+            }
+        }
+        break;
+    }
+    case GAINERS:
+    case LOSERS:
+    case VOLUME: {
+        int n = TopStocks::DEF_K;
+        if (!(in >> date) || !(in.eof() || in >> n)) {
+            error = "a date and a number of stocks are needed";
+            return false;
+        }
+        if (n < 0) {
+            error = "the number of stocks must not be negative";
+            return false;
+        }
+        int found = cmd == GAINERS ? db.getGainers(date, n, result) :
+                    cmd == LOSERS ? db.getLosers(date, n, result) :
+                    db.getVolumeLeaders(date, n, result);
+        if (found < 0) {
+            error = "invalid date";
+            return false;
+        }
+        break;
+    }
+    case INDICATORS: {
+        if (!(in >> symbol)) {
+            error = "a symbol is needed";
+            return false;
+        }
+        in >> date;
+        Indicators ind;
+        int found = db.getIndicators(symbol, date, ind);
+        if (found < 0) {
+            error = "invalid date";
+            return false;
+        }
+        if (found > 0) {
+            double values[] = {ind.sma, ind.ema, ind.vwap, ind.lower, ind.upper};
+            lines += symbol;
+            lines += ' ';
+            lines += ind.stock->getDate();
+            lines += ' ';
+            appendNumber(lines, ind.count);
+            for (int i = 0; i < 5; i++) {
+                lines += ' ';
+                appendFixed(lines, values[i], 4);
+            }
+            lines += '\n';
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return true;
+}
+
+//**************************************************
+// write the buffered results
+//**************************************************
+void BatchRunner::flush()
+{
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    buffer.clear();
+}
+
+//**************************************************
+// report the count, errors, throughput and latency
+// percentiles of each command that was run
+// - input param: the stream to report to
+//**************************************************
+void BatchRunner::showStats(ostream& os) const
+{
+    double total = 0;
+    os << fixed << setprecision(2);
+    os << "# " << left << setw(11) << "command" << right << setw(9) << "count"
+       << setw(8) << "errors" << setw(14) << "ops/s" << setw(12) << "mean us"
+       << setw(12) << "p50 us" << setw(12) << "p99 us" << setw(12) << "max us" << endl;
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        const CommandStats& s = stats[i];
+        if (s.count == 0) {
+            continue;
+        }
+        vector<double> sorted(s.latencies);
+        sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        total += s.totalSecs;
+        os << "# " << left << setw(11) << getCommandName(static_cast<Command>(i)) << right
+           << setw(9) << s.count << setw(8) << s.errors
+           << setw(14) << (s.totalSecs > 0 ? s.count / s.totalSecs : 0)
+           << setw(12) << s.totalSecs * 1e6 / s.count
+           << setw(12) << sorted[n / 2]
+           << setw(12) << sorted[(n * 99 + 99) / 100 - 1]
+           << setw(12) << s.maxLatency << endl;
+    }
+    os << "# " << numCommands << " commands in " << total << " s ("
+       << (total > 0 ? numCommands / total : 0) << " ops/s)" << endl;
+}
@@ -0,0 +1,121 @@
+// Specification file for the BatchRunner class
+// BatchRunner runs StockDB commands from a script file without prompts,
+//   stockdb stocksDB.txt --script ops.txt [--out results.txt]
+// One command per line, with its arguments on the same line:
+//   add SYMBOL Company Name; mm/dd/year; price high low change volume yearHigh yearLow
+//   get SYMBOL mm/dd/year
+//   mget SYMBOL mm/dd/year [SYMBOL mm/dd/year ...]   stocks found, in order
+//   company Company Name
+//   range SYMBOL mm/dd/year mm/dd/year
+//   gainers mm/dd/year [N]     N (20) stocks of the date with the largest change
+//   losers mm/dd/year [N]      the smallest change
+//   volume mm/dd/year [N]      the largest volume
+//   indicators SYMBOL [mm/dd/year]   at the last stock on or before the date
+//   del SYMBOL mm/dd/year
+//   delcompany Company Name
+//   undo
+//   screen conditions (see Screener)
+//   save [filename]
+//   count
+//   table [offset [limit]]     stocks sorted by company name
+// Blank lines and lines starting with # are skipped.
+// Each command writes one result line, "OK command N" followed by N
+// lines, or "ERR command message". The lines are stocks in the DB file
+// line format, except for count, whose line is the number of stocks,
+// and indicators, whose line is "SYMBOL DATE COUNT SMA EMA VWAP LOWER
+// UPPER": the date of the stock the indicators are at, the number of
+// stocks they are over, and the Bollinger bands, with 4 decimals.
+// The time of each command is recorded, and the throughput and the
+// latency percentiles of each command are reported at the end on
+// lines starting with #. The percentiles are over the latencies of up
+// to MAX_SAMPLES runs of a command, and over a uniform sample of that
+// many runs beyond that, so a long-running server keeps bounded stats.
+
+#ifndef BATCH_RUNNER_H_
+#define BATCH_RUNNER_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+using std::string;
+using std::vector;
+using std::ostream;
+
+class StockDB;
+class Stock;
+
+class BatchRunner
+{
+public:
+    // the script commands
+    enum Command {ADD, GET, COMPANY, RANGE, DELETE, DELCOMPANY, UNDO, SCREEN,
+                  SAVE, COUNT, TABLE, MGET, GAINERS, LOSERS, VOLUME,
+                  INDICATORS, NUM_COMMANDS};
+
+private:
+    // the times and errors of one command
+    struct CommandStats
+    {
+        vector<double> latencies;   // microseconds, a sample of the runs
+        long long count;            // number of runs
+        int errors;
+        double totalSecs;
+        double maxLatency;          // microseconds
+    };
+
+    // write the buffered results when they reach this size
+    static const size_t FLUSH_SIZE = 1 << 20;
+
+    // the most latencies kept per command
+    static const size_t MAX_SAMPLES = 1 << 16;
+
+    StockDB& db;
+    ostream& out;
+    string buffer;                          // results not yet written
+    CommandStats stats[NUM_COMMANDS];
+    long long numCommands;
+    uint64_t seed;                          // picks the sampled latencies
+
+public:
+    // constructor, the results are written to out
+    BatchRunner(StockDB& db, ostream& out);
+
+    // the name of a command
+    static const char* getCommandName(Command cmd);
+
+    // run the commands of a script file
+    // return false if the file cannot be opened
+    bool runFile(const string& filename);
+
+    // run one command line, the result is buffered
+    // return false if the command failed
+    bool runCommand(const string& line, int lineNo);
+
+    // run one command line and append its result to output
+    // instead of the buffer, e.g. for a server connection
+    // return false if the command failed
+    bool runCommand(const string& line, int lineNo, string& output);
+
+    // write the buffered results
+    void flush();
+
+    // report the count, errors, throughput and latency
+    // percentiles of each command to os
+    void showStats(ostream& os) const;
+
+private:
+    // record the latency of a run of a command
+    void addLatency(CommandStats& s, double us);
+
+    // run a parsed command and collect the stocks of its result,
+    // or the lines of a result that is not stocks (e.g. count)
+    // return false and the reason if it failed
+    bool execute(Command cmd, const string& args, int lineNo,
+                 vector<Stock*>& result, string& lines, string& error);
+
+    // the command of a name, NUM_COMMANDS if there is none
+    static Command findCommand(const string& name);
+};
+
+#endif // BATCH_RUNNER_H_
@@ -0,0 +1,1219 @@
+// Implementation file for the benchmark functions
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <cmath>
+using namespace std;
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "Stock.h"
+#include "StockDB.h"
+#include "HashTable.h"
+#include "FlatHashTable.h"
+#include "BinarySearchTree.h"
+#include "AVLTree.h"
+#include "CompanyIndex.h"
+#include "ObjectPool.h"
+#include "StockColumns.h"
+#include "Screener.h"
+#include "ConcurrentIndex.h"
+#include "SymbolIndex.h"
+#include "Utils.h"
+#include "AllocCount.h"
+#include "Benchmark.h"
+
+// DB filename used by the benchmarks, so the log files
+// do not overwrite the default output DB files
+static const string BENCH_DB_FILENAME = "benchStockDB";
+
+//**************************************************
+// create N stocks with distinct symbols and dates
+// - input params: the number of stocks, and the vector
+//                 to store the new stocks in
+//**************************************************
+static void makeStocks(int n, vector<Stock*>& stocks)
+{
+    const int NUM_SYMBOLS = 5000;
+    for (int i = 0; i < n; i++) {
+        int sym = i % NUM_SYMBOLS;
+        int day = i / NUM_SYMBOLS;
+        string symbol = "S" + to_string(sym);
+        string company = "Company " + to_string(sym);
+        string date = to_string(day % 12 + 1) + "/" + to_string(day / 12 % 28 + 1) + "/" +
+                      to_string(2000 + day / 336);
+        double price = 10 + (i % 997) * 0.25;
+        stocks.push_back(new Stock(symbol, company, date, price, price * 1.01, price * 0.99,
+                                   (i % 7) - 3.0, 1000 + i, price * 1.5, price * 0.5));
+    }
+}
+
+//**************************************************
+// print one result line of a benchmark
+// - input params: the name of the measured case, the number
+//                 of operations, and the elapsed seconds
+//**************************************************
+static void report(const string& name, int n, double secs)
+{
+    cout << fixed << setprecision(2);
+    cout << "  " << left << setw(28) << name << right
+         << setw(12) << (secs > 0 ? n / secs : 0) << " ops/s"
+         << setw(10) << (n > 0 ? secs * 1e6 / n : 0) << " us/op" << endl;
+}
+
+//**************************************************
+// seconds elapsed since start
+//**************************************************
+static double since(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+//**************************************************
+// mutation throughput with the write-ahead log off and on
+// Each case adds N stocks, deletes them, and undoes the deletes
+// - input param: the number of stocks
+//**************************************************
+static void benchLog(int n)
+{
+    struct LogCase {
+        const char* name;
+        bool enabled;
+        int syncEvery;
+    };
+    const LogCase cases[] = {
+        {"no log", false, 0},
+        {"log, no fsync", true, 0},
+        {"log, fsync every 100", true, 100},
+        {"log, fsync every 10", true, 10},
+        {"log, fsync every commit", true, 1},
+    };
+    string logFile = BENCH_DB_FILENAME + ".wal";
+
+    cout << "Write-ahead log: " << n << " adds, deletes and undos" << endl;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        vector<Stock*> stocks;
+        makeStocks(n, stocks);
+
+        remove(logFile.c_str());
+        StockDB db;
+        db.setDBFile(BENCH_DB_FILENAME);
+        db.setLogEnabled(cases[c].enabled);
+        db.setLogSync(cases[c].syncEvery);
+        db.openLog(BENCH_DB_FILENAME);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            if (!db.addStock(stocks[i])) {
+                delete stocks[i];
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            db.deleteSymbol(stocks[i]->getSymbol(), stocks[i]->getDate());
+        }
+        for (int i = 0; i < n; i++) {
+            db.undoLastDelete();
+        }
+        report(cases[c].name, 3 * n, since(start));
+    }
+    remove(logFile.c_str());
+}
+
+//**************************************************
+// insert, search and remove N stocks in a hash table
+// - input params: the name of the table, the table,
+//                 and the number of stocks
+//**************************************************
+template<class Table>
+static void benchTable(const string& name, Table& table, int n)
+{
+    vector<Stock*> stocks;
+    vector<Stock*> missing;
+    makeStocks(2 * n, stocks);
+    // the second half is only used for unsuccessful searches
+    missing.assign(stocks.begin() + n, stocks.end());
+    stocks.resize(n);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        table.insert(stocks[i]);
+    }
+    report(name + " insert", n, since(start));
+
+    Stock* dataOut;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        table.search(*stocks[i], dataOut);
+    }
+    report(name + " search hit", n, since(start));
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        table.search(*missing[i], dataOut);
+    }
+    report(name + " search miss", n, since(start));
+
+    table.showStatistics();
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        table.remove(*stocks[i], dataOut);
+    }
+    report(name + " remove", n, since(start));
+
+    for (int i = 0; i < n; i++) {
+        delete stocks[i];
+        delete missing[i];
+    }
+}
+
+//**************************************************
+// chained HashTable against open-addressing FlatHashTable
+// Both tables have 2N buckets or slots and the same hash policy
+// - input param: the number of stocks
+//**************************************************
+static void benchHashTables(int n)
+{
+    int size = nextPrime(2 * n);
+    cout << "Hash tables: " << n << " stocks, " << size << " buckets" << endl;
+    {
+        HashTable<Stock, WyHash<Stock> > table(size);
+        benchTable("chained", table, n);
+    }
+    {
+        FlatHashTable<Stock, WyHash<Stock> > table(size);
+        benchTable("open addressing", table, n);
+    }
+}
+
+//**************************************************
+// insert latency of a growing HashTable
+// The table starts at 101 buckets and doubles when its load
+// factor is over 75%. The blocking case moves all the buckets
+// as soon as the table grows, the incremental case moves a few
+// on each insert.
+// - input param: the number of stocks
+//**************************************************
+static void benchRehash(int n)
+{
+    cout << "HashTable rehash: " << n << " inserts from 101 buckets" << endl;
+    for (int blocking = 1; blocking >= 0; blocking--) {
+        vector<Stock*> stocks;
+        makeStocks(n, stocks);
+        vector<double> latency(n);
+        HashTable<Stock, WyHash<Stock> > table(101);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            chrono::steady_clock::time_point opStart = chrono::steady_clock::now();
+            table.insert(stocks[i]);
+            if (blocking) {
+                table.finishRehash();
+            }
+            latency[i] = since(opStart);
+        }
+        string name = blocking ? "blocking" : "incremental";
+        report(name + " insert", n, since(start));
+
+        sort(latency.begin(), latency.end());
+        size_t p99 = min<size_t>(n - 1, static_cast<size_t>(static_cast<long long>(n) * 99 / 100));
+        size_t p9999 = min<size_t>(n - 1, static_cast<size_t>(static_cast<long long>(n) * 9999 / 10000));
+        cout << "    p99 " << latency[p99] * 1e6 << " us"
+             << ", p99.99 " << latency[p9999] * 1e6 << " us"
+             << ", max " << latency[n - 1] * 1e6 << " us" << endl;
+        // the table deletes the stocks
+    }
+}
+
+//**************************************************
+// insert, search and remove stocks in a tree, in the
+// order of the vector, and print the height of the full tree
+// - input params: the name of the tree, the tree, and the stocks
+//**************************************************
+template<class Tree>
+static void benchTree(const string& name, Tree& tree, const vector<Stock*>& stocks)
+{
+    int n = static_cast<int>(stocks.size());
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        tree.insert(stocks[i]);
+    }
+    report(name + " insert", n, since(start));
+
+    Stock* dataOut;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        tree.search(*stocks[i], dataOut);
+    }
+    report(name + " search", n, since(start));
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        tree.remove(*stocks[i], dataOut);
+    }
+    report(name + " remove", n, since(start));
+}
+
+//**************************************************
+// unbalanced BinarySearchTree against AVLTree on stocks inserted
+// in company order, in reverse company order, in random order,
+// and all with the same company
+// The BST is O(n) per operation on all but the random order,
+// so it is skipped above BST_MAX stocks
+// - input param: the number of stocks
+//**************************************************
+static void benchTrees(int n)
+{
+    const int BST_MAX = 20000;
+    const char* orders[] = {"sorted", "reverse sorted", "random", "one company"};
+
+    for (int o = 0; o < 4; o++) {
+        vector<Stock*> stocks;
+        makeStocks(n, stocks);
+        for (int i = 0; i < n; i++) {
+            string company = to_string(o == 1 ? n - i : i);
+            company.insert(0, 8 - company.size(), '0');
+            stocks[i]->setCompanyName(o == 3 ? "Company" : "Company " + company);
+        }
+        if (o == 2) {
+            shuffle(stocks.begin(), stocks.end(), mt19937(12345));
+        }
+
+        cout << "Trees: " << n << " stocks, " << orders[o] << endl;
+        if (n <= BST_MAX) {
+            BinarySearchTree<Stock> tree(compare);
+            benchTree("BST", tree, stocks);
+        }
+        else {
+            cout << "  BST skipped above " << BST_MAX << " stocks" << endl;
+        }
+        {
+            AVLTree<Stock> tree(compare);
+            for (int i = 0; i < n; i++) {
+                tree.insert(stocks[i]);
+            }
+            cout << "  AVL height " << tree.getHeight() << endl;
+            tree.clear();
+            benchTree("AVL", tree, stocks);
+        }
+
+        for (int i = 0; i < n; i++) {
+            delete stocks[i];
+        }
+    }
+}
+
+//**************************************************
+// print one result line of a benchmark with the allocations
+// - input params: the name of the measured case, the number of
+//                 operations, the elapsed seconds, and the allocations
+//**************************************************
+static void reportAllocs(const string& name, int n, double secs, long long allocs)
+{
+    cout << fixed << setprecision(2);
+    cout << "  " << left << setw(28) << name << right
+         << setw(12) << (secs > 0 ? n / secs : 0) << " ops/s"
+         << setw(10) << (n > 0 ? static_cast<double>(allocs) / n : 0) << " allocs/op" << endl;
+}
+
+//**************************************************
+// time N lookups and count their allocations
+// - input params: the name of the case, the number of lookups,
+//                 and the function doing lookup i, which
+//                 returns true if found
+//**************************************************
+template<class Lookup>
+static void benchLookup(const string& name, int n, Lookup lookup)
+{
+    int found = 0;
+    long long allocs = getAllocCount();
+    setAllocCounting(true);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        if (lookup(i)) {
+            found++;
+        }
+    }
+    double secs = since(start);
+    setAllocCounting(false);
+    allocs = getAllocCount() - allocs;
+    reportAllocs(name, n, secs, allocs);
+    if (found != n) {
+        cout << "  (" << n - found << " not found)" << endl;
+    }
+}
+
+//**************************************************
+// allocations per lookup: a probe Stock built for every lookup,
+// as the lookups used to do, against a StockKey or a string_view
+// made from the query strings
+// The symbols of the second hash case are too long to pack
+// and the company names too long for the short string buffer,
+// so every string copy allocates
+// - input param: the number of stocks and lookups
+//**************************************************
+static void benchAlloc(int n)
+{
+    const char* symbolCases[] = {"packed symbols", "long symbols"};
+    for (int c = 0; c < 2; c++) {
+        vector<Stock*> stocks;
+        makeStocks(n, stocks);
+        for (int i = 0; i < n; i++) {
+            if (c == 1) {
+                stocks[i]->setSymbol("LONG.SYMBOL." + stocks[i]->getSymbol());
+            }
+            stocks[i]->setCompanyName("Incorporated Company Number " +
+                                      to_string(i % 5000));
+        }
+
+        HashTable<Stock, WyHash<Stock> > table;
+        table.reserve(n);
+        CompanyIndex companies;
+        for (int i = 0; i < n; i++) {
+            table.insert(stocks[i]);
+            companies.insert(stocks[i]);
+        }
+
+        // the query strings, in random order
+        vector<string> symbols, dates, names;
+        vector<int> order(n);
+        for (int i = 0; i < n; i++) {
+            order[i] = i;
+        }
+        shuffle(order.begin(), order.end(), mt19937(12345));
+        for (int i = 0; i < n; i++) {
+            symbols.push_back(stocks[order[i]]->getSymbol());
+            dates.push_back(stocks[order[i]]->getDate());
+            names.push_back(stocks[order[i]]->getCompanyName());
+        }
+
+        cout << "Lookups: " << n << " stocks, " << symbolCases[c] << endl;
+        benchLookup("hash, Stock probe", n, [&](int i) {
+            Stock probe(symbols[i], "", dates[i], 0, 0, 0, 0, 0, 0, 0);
+            Stock* dataOut;
+            return table.search(probe, dataOut) != -1;
+        });
+        benchLookup("hash, StockKey probe", n, [&](int i) {
+            Stock* dataOut;
+            return table.search(StockKey(symbols[i], dates[i]), dataOut) != -1;
+        });
+        benchLookup("company, string probe", n, [&](int i) {
+            string company(names[i].data(), names[i].size());
+            return companies.search(company) != NULL;
+        });
+        benchLookup("company, string_view probe", n, [&](int i) {
+            return companies.search(names[i]) != NULL;
+        });
+
+        // the hash table deletes the stocks
+    }
+}
+
+//**************************************************
+// the resident memory of the process in bytes
+// - return 0 if it is not known on this platform
+//**************************************************
+static long long residentBytes()
+{
+#ifndef _WIN32
+    ifstream statm("/proc/self/statm");
+    long long pages, resident;
+    if (statm >> pages >> resident) {
+        return resident * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+//**************************************************
+// build and free a hash table of N stocks with the stocks and
+// list nodes allocated one by one, and from object pools
+// The pool case runs first, so the other case cannot
+// reuse the memory it frees
+// - input param: the number of stocks
+//**************************************************
+static void benchPool(int n)
+{
+    cout << "Object pools: " << n << " stocks in a HashTable" << endl;
+    for (int pooled = 1; pooled >= 0; pooled--) {
+        ObjectPool<Stock> stockPool;
+        ObjectPool<ListNode<Stock> > nodePool;
+        long long rss = residentBytes();
+        HashTable<Stock, WyHash<Stock> >* table = new HashTable<Stock, WyHash<Stock> >();
+        table->reserve(n);
+        if (pooled) {
+            table->setPools(&stockPool, &nodePool);
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            // the symbols and dates of makeStocks
+            int day = i / 5000;
+            string symbol = "S" + to_string(i % 5000);
+            string date = to_string(day % 12 + 1) + "/" + to_string(day / 12 % 28 + 1) + "/" +
+                          to_string(2000 + day / 336);
+            double price = 10 + (i % 997) * 0.25;
+            Stock* stk;
+            if (pooled) {
+                stk = stockPool.create(symbol, "Company", date, price, price, price,
+                                       0.0, i, price, price);
+            }
+            else {
+                stk = new Stock(symbol, "Company", date, price, price, price,
+                                0.0, i, price, price);
+            }
+            table->insert(stk);
+        }
+        string name = pooled ? "pool" : "new/delete";
+        report(name + " build", n, since(start));
+        cout << "    memory " << (residentBytes() - rss) / (1024 * 1024) << " MB" << endl;
+
+        start = chrono::steady_clock::now();
+        delete table;
+        stockPool.release();
+        nodePool.release();
+        report(name + " free", n, since(start));
+    }
+}
+
+//**************************************************
+// average price of N stocks read through Stock pointers, in
+// creation order and in random order (like a walk of an index),
+// against a scan of the price column of a StockColumns
+// Each case repeats the scan until it has read at least 10M rows
+// - input param: the number of stocks
+//**************************************************
+static void benchScan(int n)
+{
+    cout << "Column scan: average price of " << n << " stocks" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    StockColumns columns;
+    columns.reserve(n);
+    for (int i = 0; i < n; i++) {
+        columns.add(stocks[i]);
+    }
+    vector<Stock*> shuffled(stocks);
+    mt19937 rng(12345);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    int reps = max(1, 10000000 / max(n, 1));
+    double check = 0;
+    for (int c = 0; c < 3; c++) {
+        const vector<Stock*>& order = c == 0 ? stocks : shuffled;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        double sum = 0;
+        for (int r = 0; r < reps; r++) {
+            if (c < 2) {
+                for (int i = 0; i < n; i++) {
+                    sum += order[i]->getPrice();
+                }
+            }
+            else {
+                sum += columns.summarize(StockColumns::PRICE).sum;
+            }
+        }
+        double secs = since(start);
+        static const char* names[] = {"Stock* in order", "Stock* random order", "price column"};
+        report(names[c], n * reps, secs);
+        check += sum / reps;
+    }
+    cout << "    average price " << check / 3 / max(n, 1) << endl;
+
+    for (int i = 0; i < n; i++) {
+        delete stocks[i];
+    }
+}
+
+//**************************************************
+// screen N stocks with "change > 2 volume > V price >= 0.6 yearhigh"
+// (V is the median volume) by a walk of the company index that
+// tests each stock, and by the screener with each kernel
+// - input param: the number of stocks
+//**************************************************
+static void benchScreen(int n)
+{
+    cout << "Screen: " << n << " stocks, change > 2 volume > median price >= 0.6 yearhigh" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    CompanyIndex index;
+    StockColumns columns;
+    columns.reserve(n);
+    for (int i = 0; i < n; i++) {
+        index.insert(stocks[i]);
+        columns.add(stocks[i]);
+    }
+
+    double volume = 1000 + n / 2;
+    Screener screener;
+    screener.addCondition(StockColumns::CHANGE, Screener::GT, 2);
+    screener.addCondition(StockColumns::VOLUME, Screener::GT, volume);
+    screener.addCondition(StockColumns::PRICE, Screener::GE, 0.6, StockColumns::YEAR_HIGH);
+
+    int reps = max(1, 10000000 / max(n, 1));
+    int found = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        found = 0;
+        index.inOrder([&](Stock& stk) {
+            if (stk.getChange() > 2 && stk.getVolume() > volume &&
+                stk.getPrice() >= 0.6 * stk.getYearHigh()) {
+                found++;
+            }
+        });
+    }
+    report("tree walk", n * reps, since(start));
+    cout << "    " << found << " stocks found" << endl;
+
+    Screener::Kernel kernels[] = {Screener::SCALAR, Screener::SSE2, Screener::AVX2};
+    for (int k = 0; k < 3; k++) {
+        if (!screener.setKernel(kernels[k])) {
+            cout << "  " << Screener::getKernelName(kernels[k]) << " not supported" << endl;
+            continue;
+        }
+        vector<uint64_t> bits;
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) {
+            found = screener.select(columns, bits);
+        }
+        report(string(Screener::getKernelName(kernels[k])) + " bitmap", n * reps, since(start));
+        cout << "    " << found << " stocks found" << endl;
+    }
+
+    for (int i = 0; i < n; i++) {
+        delete stocks[i];
+    }
+}
+
+//**************************************************
+// reader threads searching a ConcurrentIndex while the writer
+// (this thread) deletes and undeletes stocks, for 1 to 8 readers
+// It is also a stress test: the stocks with an even index are
+// never deleted and must always be found, every stock found must
+// be the one searched, and every stock of a company search must
+// have that company name; any other result is counted as an error
+// - input param: the number of stocks
+//**************************************************
+static void benchReaders(int n)
+{
+    cout << "Concurrent readers: " << n << " stocks, one writer deleting and undeleting" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    StockDB db;
+    db.setLogEnabled(false);
+    for (int i = 0; i < n; i++) {
+        db.addStock(stocks[i]);
+    }
+    db.enableConcurrentReads();
+    const ConcurrentIndex& index = *db.getConcurrentIndex();
+
+    const double SECONDS = 1.0;
+    for (int numReaders = 1; numReaders <= 8; numReaders *= 2) {
+        atomic<bool> stop(false);
+        atomic<long long> reads(0), errors(0);
+        vector<thread> readers;
+        for (int r = 0; r < numReaders; r++) {
+            readers.push_back(thread([&, r]() {
+                ConcurrentIndex::Reader reader(index);
+                mt19937 rng(r + 1);
+                vector<Stock*> found;
+                long long done = 0, bad = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    for (int j = 0; j < 256; j++, done++) {
+                        int i = rng() % n;
+                        const Stock* stk = stocks[i];
+                        if (j % 16 == 0) {
+                            // a secondary key search
+                            found.clear();
+                            reader.searchCompany(stk->getCompanyName(), found);
+                            for (size_t k = 0; k < found.size(); k++) {
+                                bad += found[k]->getCompanyName() != stk->getCompanyName();
+                            }
+                            continue;
+                        }
+                        Stock* f = reader.search(stk->getSymbol(), stk->getDate());
+                        bad += (f && f != stk) || (!f && i % 2 == 0);
+                    }
+                }
+                reads += done;
+                errors += bad;
+            }));
+        }
+
+        // delete and undelete the stocks with an odd index
+        long long writes = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 1; since(start) < SECONDS; i = (i + 2) % n) {
+            if (db.deleteSymbol(stocks[i]->getSymbol(), stocks[i]->getDate())) {
+                db.undoLastDelete();
+                writes += 2;
+            }
+        }
+        stop = true;
+        for (size_t r = 0; r < readers.size(); r++) {
+            readers[r].join();
+        }
+        double secs = since(start);
+
+        cout << "  " << numReaders << " reader" << (numReaders > 1 ? "s" : "") << ", "
+             << errors << " errors" << endl;
+        report("reads", static_cast<int>(reads), secs);
+        report("writes", static_cast<int>(writes), secs);
+    }
+}
+
+//**************************************************
+// saving the DB: the text file written with operator<<, as
+// it was before the BackgroundSaver, then saveDB on the calling
+// thread in hash, key and company order on 1 and 4 threads, then
+// a background save while the writer (this thread) deletes and
+// undeletes stocks
+// - input param: the number of stocks
+//**************************************************
+static void benchSave(int n)
+{
+    cout << "Save: " << n << " stocks, text file and snapshot" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    string textFile = BENCH_DB_FILENAME + ".txt";
+    string snapFile = BENCH_DB_FILENAME + ".sdb";
+    string logFile = BENCH_DB_FILENAME + ".wal";
+
+    // the log is on, so the background save rotates it
+    remove(logFile.c_str());
+    StockDB db;
+    db.setDBFile(BENCH_DB_FILENAME);
+    db.setLogSync(0);
+    db.openLog(BENCH_DB_FILENAME);
+    for (int i = 0; i < n; i++) {
+        db.addStock(stocks[i]);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    {
+        ofstream outFile(textFile);
+        for (int i = 0; i < n; i++) {
+            outFile << *stocks[i];
+        }
+    }
+    report("text file, operator<<", n, since(start));
+
+    ostringstream os;
+    const char* orders[] = {"hash", "key", "company"};
+    for (int o = 0; o < 3; o++) {
+        for (int threads = 1; threads <= 4; threads += 3) {
+            db.setSaveOrder(orders[o]);
+            db.setSaveThreads(threads);
+            start = chrono::steady_clock::now();
+            db.saveDB(BENCH_DB_FILENAME, os);
+            report(string("saveDB, ") + orders[o] + ", " + to_string(threads) + " thread" +
+                   (threads > 1 ? "s" : ""), n, since(start));
+        }
+    }
+    db.setSaveOrder("key");
+    db.setSaveThreads(1);
+
+    // delete and undelete the stocks with an odd index while saving
+    start = chrono::steady_clock::now();
+    db.startSave(BENCH_DB_FILENAME, os);
+    double blocked = since(start);
+    long long writes = 0;
+    for (int i = 1; db.isSaving(); i = (i + 2) % n) {
+        if (db.deleteSymbol(stocks[i]->getSymbol(), stocks[i]->getDate())) {
+            db.undoLastDelete();
+            writes += 2;
+        }
+    }
+    double secs = since(start);
+    report("startSave, caller blocked", n, blocked);
+    report("background save", n, secs);
+    report("writes during the save", static_cast<int>(writes), secs);
+    db.finishSave(cout);
+
+    remove(textFile.c_str());
+    remove(snapFile.c_str());
+    remove(logFile.c_str());
+}
+
+//**************************************************
+// a row of the table display as tDisplay wrote it before
+// the to_chars rendering: setw on every field, endl on every row
+//**************************************************
+static void streamTableRow(ostream& os, const Stock& stk)
+{
+    os << left;
+    os << " " << setw(6) << stk.getSymbol() << " ";
+    os << " " << setw(22) << stk.getCompanyName() << " ";
+    os << " " << setw(10) << stk.getDate() << " ";
+    os << fixed << setprecision(2);
+    os << " " << setw(9) << stk.getPrice() << " ";
+    os << " " << setw(9) << stk.getHigh() << " ";
+    os << " " << setw(9) << stk.getLow() << " ";
+    os << " " << setw(9) << stk.getChange() << " ";
+    os << " " << setw(9) << stk.getVolume() << " ";
+    os << " " << setw(9) << stk.getYearHigh() << " ";
+    os << " " << setw(9) << stk.getYearLow() << " ";
+    os << endl;
+}
+
+//**************************************************
+// the sorted table display: the rows written with setw and endl
+// against the to_chars rendering in 1 MB blocks, both to /dev/null,
+// and random 50-row windows of the table
+// It also checks the windows against the stocks sorted by company
+// name after a stock out of every 7 is deleted, so the companies
+// differ in size; any difference is counted as an error
+// - input param: the number of stocks
+//**************************************************
+static void benchDisplay(int n)
+{
+    cout << "Table display: " << n << " stocks sorted by company name" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    StockDB db;
+    db.setLogEnabled(false);
+    for (int i = 0; i < n; i++) {
+        db.addStock(stocks[i]);
+    }
+
+    vector<Stock*> expected;
+    for (int i = 0; i < n; i++) {
+        if (i % 7 == 0) {
+            db.deleteSymbol(stocks[i]->getSymbol(), stocks[i]->getDate());
+        }
+        else {
+            expected.push_back(stocks[i]);
+        }
+    }
+    sort(expected.begin(), expected.end(), [](const Stock* s1, const Stock* s2) {
+        int c = s1->getCompanyName().compare(s2->getCompanyName());
+        return c < 0 || (c == 0 && *s1 < *s2);
+    });
+    int m = static_cast<int>(expected.size());
+
+    mt19937 rng(1);
+    int errors = 0;
+    vector<Stock*> rows;
+    for (int k = 0; k < 1000; k++) {
+        long long offset = rng() % (m + 10);
+        int limit = rng() % 100;
+        rows.clear();
+        db.getSortedStocks(offset, limit, rows);
+        long long last = min(static_cast<long long>(m), offset + limit);
+        errors += rows.size() != static_cast<size_t>(max(0LL, last - offset)) ||
+                  !equal(rows.begin(), rows.end(), expected.begin() + min(offset, last));
+    }
+    cout << "  " << m << " rows, " << errors << " window errors" << endl;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    {
+        ofstream outFile("/dev/null");
+        for (int i = 0; i < m; i++) {
+            streamTableRow(outFile, *expected[i]);
+        }
+    }
+    report("setw + endl rows", m, since(start));
+
+    start = chrono::steady_clock::now();
+    {
+        ofstream outFile("/dev/null");
+        db.displayDB(outFile, 0, m);
+    }
+    report("to_chars rows, 1 MB blocks", m, since(start));
+
+    const int WINDOWS = 10000;
+    start = chrono::steady_clock::now();
+    for (int k = 0; k < WINDOWS; k++) {
+        rows.clear();
+        db.getSortedStocks(rng() % m, 50, rows);
+    }
+    report("50-row window", WINDOWS, since(start));
+}
+
+//**************************************************
+// lookups of many keys by symbol and date: one searchSymbol
+// per key against searchSymbols on batches of 1 key to all
+// the keys, on 1 thread and on 4 threads for the whole batch
+// The keys are in random order, so most buckets are cache misses,
+// and every stock found is checked against the stock searched
+// - input param: the number of stocks, also the number of lookups
+//**************************************************
+static void benchMultiGet(int n)
+{
+    cout << "Multi-get: " << n << " lookups by symbol and date of " << n << " stocks" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    StockDB db;
+    db.setLogEnabled(false);
+    for (int i = 0; i < n; i++) {
+        db.addStock(stocks[i]);
+    }
+
+    // the stocks in random order, and their keys
+    vector<Stock*> order(stocks);
+    shuffle(order.begin(), order.end(), mt19937(1));
+    vector<StockKey> keys;
+    keys.reserve(n);
+    for (int i = 0; i < n; i++) {
+        keys.push_back(StockKey(*order[i]));
+    }
+
+    long long errors = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        errors += db.searchSymbol(keys[i].getSymbol(), keys[i].getDate()) != order[i];
+    }
+    report("searchSymbol", n, since(start));
+
+    // batches of 1 (no prefetching, but the keys are already
+    // built), 16, 256, ... keys, then one batch of all the keys
+    // on 1 and on 4 threads
+    vector<int> sizes(1, 1);
+    for (int size = 16; size < n; size *= 16) {
+        sizes.push_back(size);
+    }
+    sizes.push_back(n);
+    sizes.push_back(n);
+
+    vector<Stock*> found;
+    for (size_t s = 0; s < sizes.size(); s++) {
+        int size = sizes[s];
+        int numThreads = s + 1 < sizes.size() ? 1 : 4;
+        db.setSearchThreads(numThreads);
+
+        // split the keys into batches before the timing
+        vector<vector<StockKey> > batches;
+        for (int first = 0; first < n; first += size) {
+            batches.push_back(vector<StockKey>(keys.begin() + first,
+                                               keys.begin() + min(n, first + size)));
+        }
+
+        int first = 0;
+        start = chrono::steady_clock::now();
+        for (size_t b = 0; b < batches.size(); b++) {
+            db.searchSymbols(batches[b], found);
+            for (size_t i = 0; i < found.size(); i++, first++) {
+                errors += found[i] != order[first];
+            }
+        }
+        report("batch of " + to_string(size) +
+               (numThreads > 1 ? ", " + to_string(numThreads) + " threads" : ""), n, since(start));
+    }
+    db.setSearchThreads(1);
+    cout << "  " << errors << " errors" << endl;
+}
+
+//**************************************************
+// the top 20 gainers, losers and volume of a date: a walk of all
+// the stocks in company order and a sort of the stocks of the date,
+// as the menu did before TopStocks, against the lists TopStocks
+// keeps up to date. The stocks are first churned by deleting and
+// undeleting stocks and whole companies, and every list is checked
+// against the walk and sort
+// - input param: the number of stocks
+//**************************************************
+static void benchTopStocks(int n)
+{
+    cout << "Top stocks: 20 gainers, losers and volume of a date, " << n << " stocks" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    StockDB db;
+    db.setLogEnabled(false);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        db.addStock(stocks[i]);
+    }
+    report("add", n, since(start));
+
+    // delete and undelete stocks and companies, leaving some deleted
+    mt19937 rng(1);
+    int numChurn = min(n, 20000);
+    vector<Stock*> deleted;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < numChurn; i++) {
+        Stock* stk = stocks[rng() % n];
+        if (i % 1000 == 0) {
+            deleted.clear();
+            db.deleteCompany(stk->getCompanyName(), deleted);
+            for (size_t j = 0; i % 2000 == 0 && j < deleted.size(); j++) {
+                db.undoLastDelete();
+            }
+        }
+        else if (db.deleteSymbol(stk->getSymbol(), stk->getDate()) && i % 3 != 0) {
+            db.undoLastDelete();
+        }
+    }
+    report("delete and undelete", numChurn, since(start));
+
+    // the dates to query
+    vector<string> dates;
+    for (int i = 0; i < n && dates.size() < 50; i += max(1, n / 50)) {
+        dates.push_back(stocks[i]->getDate());
+    }
+    const int K = 20;
+    bool (*orders[3])(const Stock*, const Stock*) = {
+        [](const Stock* s1, const Stock* s2) {
+            return s1->getChange() != s2->getChange() ? s1->getChange() > s2->getChange() : *s1 < *s2;
+        },
+        [](const Stock* s1, const Stock* s2) {
+            return s1->getChange() != s2->getChange() ? s1->getChange() < s2->getChange() : *s1 < *s2;
+        },
+        [](const Stock* s1, const Stock* s2) {
+            return s1->getVolume() != s2->getVolume() ? s1->getVolume() > s2->getVolume() : *s1 < *s2;
+        }
+    };
+
+    // walk and sort
+    vector<vector<Stock*> > expected(dates.size() * 3);
+    vector<Stock*> all, ofDate;
+    start = chrono::steady_clock::now();
+    for (size_t d = 0; d < dates.size(); d++) {
+        all.clear();
+        db.getSortedStocks(0, db.getNumStocks(), all);
+        ofDate.clear();
+        for (size_t i = 0; i < all.size(); i++) {
+            if (all[i]->getDate() == dates[d]) {
+                ofDate.push_back(all[i]);
+            }
+        }
+        for (int r = 0; r < 3; r++) {
+            sort(ofDate.begin(), ofDate.end(), orders[r]);
+            expected[d * 3 + r].assign(ofDate.begin(), ofDate.begin() + min<size_t>(K, ofDate.size()));
+        }
+    }
+    report("walk and sort", static_cast<int>(dates.size()) * 3, since(start));
+
+    // the kept lists, many times over
+    const int ROUNDS = 1000;
+    long long errors = 0;
+    vector<Stock*> found;
+    start = chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t d = 0; d < dates.size(); d++) {
+            for (int r = 0; r < 3; r++) {
+                found.clear();
+                if (r == 0) {
+                    db.getGainers(dates[d], K, found);
+                }
+                else if (r == 1) {
+                    db.getLosers(dates[d], K, found);
+                }
+                else {
+                    db.getVolumeLeaders(dates[d], K, found);
+                }
+                errors += found != expected[d * 3 + r];
+            }
+        }
+    }
+    report("TopStocks", ROUNDS * static_cast<int>(dates.size()) * 3, since(start));
+    cout << "  " << errors << " errors" << endl;
+}
+
+//**************************************************
+// the indicators of a symbol from all its stocks up to a date,
+// as they were computed outside the DB before SymbolIndex kept them
+// - input params: the stocks of the symbol in date order, the
+//                 number of them up to the date, the period,
+//                 and the indicators to fill
+//**************************************************
+static void rescanIndicators(const vector<Stock*>& history, int n, int period, Indicators& out)
+{
+    double alpha = 2.0 / (period + 1);
+    double ema = 0;
+    for (int i = 0; i < n; i++) {
+        ema = i == 0 ? history[i]->getPrice() : alpha * history[i]->getPrice() + (1 - alpha) * ema;
+    }
+    double sum = 0, sumPV = 0, sumV = 0;
+    int first = max(0, n - period);
+    for (int i = first; i < n; i++) {
+        sum += history[i]->getPrice();
+        sumPV += history[i]->getPrice() * history[i]->getVolume();
+        sumV += history[i]->getVolume();
+    }
+    out.stock = history[n - 1];
+    out.count = n - first;
+    out.sma = sum / out.count;
+    out.ema = ema;
+    out.vwap = sumV > 0 ? sumPV / sumV : out.sma;
+    double var = 0;
+    for (int i = first; i < n; i++) {
+        var += (history[i]->getPrice() - out.sma) * (history[i]->getPrice() - out.sma);
+    }
+    out.stddev = sqrt(var / out.count);
+    out.lower = out.sma - SymbolIndex::BOLLINGER_WIDTH * out.stddev;
+    out.upper = out.sma + SymbolIndex::BOLLINGER_WIDTH * out.stddev;
+}
+
+//**************************************************
+// the price indicators of a symbol: adding the stocks in date
+// order, deleting and undeleting stocks before the last date,
+// then the indicators kept by the DB at the last stock and at
+// an earlier date, against a rescan of the history of the symbol
+// up to the date; every result is checked against the rescan
+// - input param: the number of stocks
+//**************************************************
+static void benchIndicators(int n)
+{
+    cout << "Indicators: SMA, EMA, VWAP and Bollinger bands over "
+         << SymbolIndex::DEF_PERIOD << " stocks, " << n << " stocks" << endl;
+    vector<Stock*> stocks;
+    makeStocks(n, stocks);
+    stable_sort(stocks.begin(), stocks.end(), [](const Stock* s1, const Stock* s2) {
+        return s1->getDays() < s2->getDays();
+    });
+    StockDB db;
+    db.setLogEnabled(false);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        db.addStock(stocks[i]);
+    }
+    report("add in date order", n, since(start));
+
+    // delete stocks and undelete most of them, out of date order
+    mt19937 rng(1);
+    int numChurn = min(n, 20000);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < numChurn; i++) {
+        Stock* stk = stocks[rng() % n];
+        if (db.deleteSymbol(stk->getSymbol(), stk->getDate()) && i % 4 != 0) {
+            db.undoLastDelete();
+        }
+    }
+    report("delete and undelete", numChurn, since(start));
+
+    // the symbols and dates to query, at the last stock and before it
+    const int NUM_QUERIES = 2000;
+    vector<string> symbols, dates;
+    for (int q = 0; q < NUM_QUERIES; q++) {
+        Stock* stk = stocks[rng() % n];
+        symbols.push_back(stk->getSymbol());
+        dates.push_back(q % 2 == 0 ? "" : stk->getDate());
+    }
+
+    // rescan the history of each symbol
+    vector<Indicators> expected(NUM_QUERIES);
+    vector<int> found(NUM_QUERIES, 0);
+    vector<Stock*> history;
+    start = chrono::steady_clock::now();
+    for (int q = 0; q < NUM_QUERIES; q++) {
+        history.clear();
+        db.searchRange(symbols[q], "1/1/1", dates[q].empty() ? "12/31/9999" : dates[q], history);
+        if (!history.empty()) {
+            rescanIndicators(history, static_cast<int>(history.size()),
+                             SymbolIndex::DEF_PERIOD, expected[q]);
+            found[q] = 1;
+        }
+    }
+    report("rescan", NUM_QUERIES, since(start));
+
+    // the indicators kept by the DB, many times over
+    const int ROUNDS = 100;
+    long long errors = 0;
+    for (int last = 1; last >= 0; last--) {
+        start = chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int q = (last ? 0 : 1); q < NUM_QUERIES; q += 2) {
+                Indicators ind;
+                const Indicators& e = expected[q];
+                if (db.getIndicators(symbols[q], dates[q], ind) != found[q]) {
+                    errors++;
+                    continue;
+                }
+                if (!found[q]) {
+                    continue;
+                }
+                double values[] = {ind.sma - e.sma, ind.ema - e.ema, ind.vwap - e.vwap,
+                                   ind.lower - e.lower, ind.upper - e.upper};
+                bool bad = ind.stock != e.stock || ind.count != e.count;
+                for (int i = 0; i < 5; i++) {
+                    bad = bad || fabs(values[i]) > 1e-6 * max(1.0, fabs(e.sma));
+                }
+                errors += bad;
+            }
+        }
+        report(last ? "DB, at the last stock" : "DB, at an earlier date",
+               ROUNDS * NUM_QUERIES / 2, since(start));
+    }
+    cout << "  " << errors << " errors" << endl;
+}
+
+//**************************************************
+// run the named benchmark on N records
+// - input params: the benchmark name, and the number of records,
+//                 0 for the default sizes of the benchmark
+// - return false if there is no benchmark with that name
+//**************************************************
+bool runBenchmark(const string& name, int n)
+{
+    if (name == "wal") {
+        benchLog(n > 0 ? n : 20000);
+    }
+    else if (name == "hash") {
+        if (n > 0) {
+            benchHashTables(n);
+        }
+        else {
+            benchHashTables(1000000);
+            benchHashTables(10000000);
+        }
+    }
+    else if (name == "tree") {
+        if (n > 0) {
+            benchTrees(n);
+        }
+        else {
+            benchTrees(5000);
+            benchTrees(1000000);
+        }
+    }
+    else if (name == "rehash") {
+        benchRehash(n > 0 ? n : 1000000);
+    }
+    else if (name == "alloc") {
+        benchAlloc(n > 0 ? n : 1000000);
+    }
+    else if (name == "pool") {
+        benchPool(n > 0 ? n : 1000000);
+    }
+    else if (name == "scan") {
+        benchScan(n > 0 ? n : 1000000);
+    }
+    else if (name == "screen") {
+        benchScreen(n > 0 ? n : 1000000);
+    }
+    else if (name == "display") {
+        benchDisplay(n > 0 ? n : 1000000);
+    }
+    else if (name == "save") {
+        benchSave(n > 0 ? n : 1000000);
+    }
+    else if (name == "readers") {
+        benchReaders(n > 0 ? n : 1000000);
+    }
+    else if (name == "mget") {
+        benchMultiGet(n > 0 ? n : 1000000);
+    }
+    else if (name == "top") {
+        benchTopStocks(n > 0 ? n : 1000000);
+    }
+    else if (name == "indicators") {
+        benchIndicators(n > 0 ? n : 1000000);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
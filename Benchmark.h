@@ -0,0 +1,17 @@
+// Specification file for the benchmark functions
+// The benchmarks are run from the command line with
+//   stockdb --bench name [N]
+// and print the throughput of the operations they measure.
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <string>
+using std::string;
+
+// run the named benchmark on N records, or on the default
+// sizes of the benchmark if N is 0
+// return false if there is no benchmark with that name
+bool runBenchmark(const string& name, int n);
+
+#endif // BENCHMARK_H_
@@ -2,6 +2,8 @@
 // It is the binary node class used by BinaryTree class 
 // Each binary node stores a pointer to the item object
 // instead of the whole item object
+// The height and the weight of the node are only used by
+// balanced trees (AVLTree)
 
 #ifndef BINARY_NODE_H_
 #define BINARY_NODE_H_
@@ -13,23 +15,29 @@ private:
     ItemType*       item;                 // Data portion (a pointer to data object)
     BinaryNode<ItemType>* leftPtr;        // Pointer to left child
     BinaryNode<ItemType>* rightPtr;       // Pointer to right child
+    int             height;               // Height of the subtree, 1 for a leaf
+    long long       weight;               // Total weight of the items of the subtree
 
 public:
     // constructors
-    BinaryNode(ItemType* anItem) {item = anItem; leftPtr = 0; rightPtr = 0;}
+    BinaryNode(ItemType* anItem) {item = anItem; leftPtr = 0; rightPtr = 0; height = 1; weight = 1;}
     BinaryNode(ItemType* anItem,
                BinaryNode<ItemType>* left,
-               BinaryNode<ItemType>* right) {item = anItem; leftPtr = left; rightPtr = right;}
+               BinaryNode<ItemType>* right) {item = anItem; leftPtr = left; rightPtr = right; height = 1; weight = 1;}
     
     // setters
     void setItem(ItemType* anItem) {item = anItem;}
     void setLeftPtr(BinaryNode<ItemType>* left) {leftPtr = left;}
     void setRightPtr(BinaryNode<ItemType>* right) {rightPtr = right;}
+    void setHeight(int h) {height = h;}
+    void setWeight(long long w) {weight = w;}
     
     // getters
     ItemType* getItem() const {return item;}
     BinaryNode<ItemType>* getLeftPtr() const {return leftPtr;}
     BinaryNode<ItemType>* getRightPtr() const {return rightPtr;}
+    int getHeight() const {return height;}
+    long long getWeight() const {return weight;}
 
     // other functions
     bool isLeaf() const {return (leftPtr == 0 && rightPtr == 0);}
@@ -75,6 +75,7 @@ bool BinarySearchTree<ItemType>::insert(ItemType* dataIn)
 {
     BinaryNode<ItemType>* newNodePtr = new BinaryNode<ItemType>(dataIn);
     this->rootPtr = _insert(this->rootPtr, newNodePtr);
+    this->count++;
     return true;
 }
 
@@ -131,6 +132,7 @@ bool BinarySearchTree<ItemType>::remove(const ItemType& target, ItemType*& dataO
         dataOut = targetNodePtr->getItem();
         // delete the actual memory of the node
         delete targetNodePtr;
+        this->count--;
         return true;
     }
     else {
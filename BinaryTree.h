@@ -1,5 +1,5 @@
 // Specification file for the BinaryTree class
-// It is the abstract base class for BinarySearchTree class
+// It is the abstract base class for BinarySearchTree and AVLTree classes
  
 #ifndef BINARY_TREE_H_
 #define BINARY_TREE_H_
@@ -22,11 +22,18 @@ public:
     bool isEmpty() const {return count == 0;}
     int getCount() const {return count;}
     void clear() {destroyTree(rootPtr); rootPtr = 0; count = 0;}
-    void preOrder(void visit(ItemType&)) const {_preorder(visit, rootPtr);}
-    void inOrder(void visit(ItemType&)) const {_inorder(visit, rootPtr);}
-    void postOrder(void visit(ItemType&)) const {_postorder(visit, rootPtr);}
-    void printTree(void visit(ItemType&, int)) const {_printTree(visit, rootPtr, 1);}
-    void printLeaf(void visit(ItemType&)) const {_printLeaf(visit, rootPtr);}
+    // the visit functions can be function pointers or function objects
+    template<class Visit> void preOrder(Visit visit) const {_preorder(visit, rootPtr);}
+    template<class Visit> void inOrder(Visit visit) const {_inorder(visit, rootPtr);}
+    template<class Visit> void postOrder(Visit visit) const {_postorder(visit, rootPtr);}
+    template<class Visit> void printTree(Visit visit) const {_printTree(visit, rootPtr, 1);}
+    template<class Visit> void printLeaf(Visit visit) const {_printLeaf(visit, rootPtr);}
+
+    // find an item by a lookup key instead of a whole item
+    // keyComp(item, key) returns < 0, 0 or > 0 like the compare
+    // function of the tree, and must order the items the same way
+    template<class Key, class KeyCompare>
+    bool find(const Key& key, KeyCompare keyComp, ItemType*& dataOut) const;
 
     // abstract functions to be implemented by derived class
     virtual bool insert(ItemType*) = 0;
@@ -38,11 +45,16 @@ private:
     void destroyTree(BinaryNode<ItemType>* nodePtr);
 
     // internal traverse
-    void _preorder(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const;
-    void _inorder(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const;
-    void _postorder(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const;
-    void _printTree(void visit(ItemType&, int), BinaryNode<ItemType>* nodePtr, int level) const;
-    void _printLeaf(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const;
+    template<class Visit>
+    void _preorder(Visit visit, BinaryNode<ItemType>* nodePtr) const;
+    template<class Visit>
+    void _inorder(Visit visit, BinaryNode<ItemType>* nodePtr) const;
+    template<class Visit>
+    void _postorder(Visit visit, BinaryNode<ItemType>* nodePtr) const;
+    template<class Visit>
+    void _printTree(Visit visit, BinaryNode<ItemType>* nodePtr, int level) const;
+    template<class Visit>
+    void _printLeaf(Visit visit, BinaryNode<ItemType>* nodePtr) const;
 }; 
 
 //**************************************************
@@ -61,13 +73,38 @@ void BinaryTree<ItemType>::destroyTree(BinaryNode<ItemType>* nodePtr)
     }
 }  
 
+//**************************************************
+// Find an item by a lookup key: iterative, allocates nothing
+// - input params: the key, and the function comparing an item
+//                 with the key
+// - if found, it sends the matching item back to the caller
+//   via the output parameter, and returns true,
+//   otherwise it returns false.
+//**************************************************
+template<class ItemType>
+template<class Key, class KeyCompare>
+bool BinaryTree<ItemType>::find(const Key& key, KeyCompare keyComp, ItemType*& dataOut) const
+{
+    BinaryNode<ItemType>* nodePtr = rootPtr;
+    while (nodePtr) {
+        int c = keyComp(*nodePtr->getItem(), key);
+        if (c == 0) {
+            dataOut = nodePtr->getItem();
+            return true;
+        }
+        nodePtr = (c > 0) ? nodePtr->getLeftPtr() : nodePtr->getRightPtr();
+    }
+    return false;
+}
+
 //**************************************************
 // Preorder Traversal
-// - input param: function pointer to process item when visited, and
+// - input param: function to process item when visited, and
 //                the pointer to the node of the subtree to process
 //**************************************************
 template<class ItemType>
-void BinaryTree<ItemType>::_preorder(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const
+template<class Visit>
+void BinaryTree<ItemType>::_preorder(Visit visit, BinaryNode<ItemType>* nodePtr) const
 {
     if (nodePtr) // != NULL
     {
@@ -80,11 +117,12 @@ void BinaryTree<ItemType>::_preorder(void visit(ItemType&), BinaryNode<ItemType>
 
 //**************************************************
 // Inorder Traversal
-// - input param: function pointer to process item when visited, and
+// - input param: function to process item when visited, and
 //                the pointer to the node of the subtree to process
 //**************************************************
 template<class ItemType>
-void BinaryTree<ItemType>::_inorder(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const
+template<class Visit>
+void BinaryTree<ItemType>::_inorder(Visit visit, BinaryNode<ItemType>* nodePtr) const
 {
     if (nodePtr) // != NULL
     {
@@ -97,11 +135,12 @@ void BinaryTree<ItemType>::_inorder(void visit(ItemType&), BinaryNode<ItemType>*
 
 //**************************************************
 // Postorder Traversal
-// - input param: function pointer to process item when visited, and
+// - input param: function to process item when visited, and
 //                the pointer to the node of the subtree to process
 //**************************************************
 template<class ItemType>
-void BinaryTree<ItemType>::_postorder(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const
+template<class Visit>
+void BinaryTree<ItemType>::_postorder(Visit visit, BinaryNode<ItemType>* nodePtr) const
 {
      if (nodePtr) // != NULL
     {
@@ -114,12 +153,13 @@ void BinaryTree<ItemType>::_postorder(void visit(ItemType&), BinaryNode<ItemType
 
 //**************************************************
 // Prints tree as an indented list
-// - input param: function pointer to print item when visited, 
+// - input param: function to print item when visited, 
 //                the pointer to the node of the subtree to print
 //                the current level of the tree for visit function
 //**************************************************
 template<class ItemType>
-void BinaryTree<ItemType>::_printTree(void visit(ItemType&, int), BinaryNode<ItemType>* nodePtr, int level) const
+template<class Visit>
+void BinaryTree<ItemType>::_printTree(Visit visit, BinaryNode<ItemType>* nodePtr, int level) const
 {
     if (nodePtr) // != NULL
     {
@@ -132,11 +172,12 @@ void BinaryTree<ItemType>::_printTree(void visit(ItemType&, int), BinaryNode<Ite
 
 //**************************************************
 // Prints leaf nodes of the tree
-// - input param: function pointer to print item when visited, and
+// - input param: function to print item when visited, and
 //                the pointer to the node of the subtree to print
 //**************************************************
 template<class ItemType>
-void BinaryTree<ItemType>::_printLeaf(void visit(ItemType&), BinaryNode<ItemType>* nodePtr) const
+template<class Visit>
+void BinaryTree<ItemType>::_printLeaf(Visit visit, BinaryNode<ItemType>* nodePtr) const
 {
     if (nodePtr) // != NULL
     {
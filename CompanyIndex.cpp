@@ -0,0 +1,186 @@
+// Implementation file for the CompanyIndex class
+
+#include <string>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "Stock.h"
+#include "CompanyIndex.h"
+
+//**************************************************
+// order two stocks of a group by their unique key
+//**************************************************
+static bool lessKey(const Stock* s1, const Stock* s2)
+{
+    return *s1 < *s2;
+}
+
+//**************************************************
+// Constructor
+//**************************************************
+CompanyIndex::CompanyIndex() : tree(compareGroups)
+{
+    count = 0;
+}
+
+//**************************************************
+// Destructor
+// deletes the groups, but not the stocks
+//**************************************************
+CompanyIndex::~CompanyIndex()
+{
+    tree.postOrder([](CompanyGroup& group) {
+        delete &group;
+    });
+}
+
+//**************************************************
+// compare the company names of two groups
+//**************************************************
+int CompanyIndex::compareGroups(const CompanyGroup& g1, const CompanyGroup& g2)
+{
+    return g1.company.compare(g2.company);
+}
+
+//**************************************************
+// compare the company name of a group with a company name
+//**************************************************
+int CompanyIndex::compareCompany(const CompanyGroup& group, const string_view& company)
+{
+    return string_view(group.company).compare(company);
+}
+
+//**************************************************
+// find the group of a company
+// - input param: the company name
+// - return the group, NULL if there is no such company
+//**************************************************
+CompanyGroup* CompanyIndex::findGroup(string_view company) const
+{
+    CompanyGroup* group = NULL;
+    if (!tree.find(company, compareCompany, group)) {
+        return NULL;
+    }
+    return group;
+}
+
+//**************************************************
+// insert a stock into the group of its company
+// A new group is created for the first stock of a company
+// - input param: the pointer to the stock to insert
+// - return true
+//**************************************************
+bool CompanyIndex::insert(Stock* dataIn)
+{
+    CompanyGroup* group = findGroup(dataIn->getCompanyName());
+    if (!group) {
+        group = new CompanyGroup;
+        group->company = dataIn->getCompanyName();
+        group->stocks.push_back(dataIn);
+        tree.insert(group);
+        count++;
+        return true;
+    }
+
+    // keep the stocks of the group sorted by unique key
+    vector<Stock*>& stocks = group->stocks;
+    stocks.insert(upper_bound(stocks.begin(), stocks.end(), dataIn, lessKey), dataIn);
+    tree.reweigh(string_view(group->company), compareCompany);
+    count++;
+
+    return true;
+}
+
+//**************************************************
+// remove a stock from the group of its company
+// The group is removed with its last stock
+// - input param: the stock with the company, symbol and date to remove
+// - return true if found, otherwise, false
+//   return the removed stock via output parameter
+//**************************************************
+bool CompanyIndex::remove(const Stock& key, Stock*& dataOut)
+{
+    CompanyGroup* group = findGroup(key.getCompanyName());
+    if (!group) {
+        return false;
+    }
+
+    vector<Stock*>& stocks = group->stocks;
+    vector<Stock*>::iterator it = lower_bound(stocks.begin(), stocks.end(), &key, lessKey);
+    if (it == stocks.end() || !(**it == key)) {
+        return false;
+    }
+    dataOut = *it;
+    stocks.erase(it);
+    count--;
+
+    if (stocks.empty()) {
+        CompanyGroup* g = NULL;
+        tree.remove(*group, g);
+        delete g;
+    }
+    else {
+        tree.reweigh(string_view(group->company), compareCompany);
+    }
+
+    return true;
+}
+
+//**************************************************
+// search the stocks of a company
+// - input param: the company name
+// - return the stocks sorted by symbol + date,
+//   NULL if there is no such company
+//**************************************************
+const vector<Stock*>* CompanyIndex::search(string_view company) const
+{
+    CompanyGroup* group = findGroup(company);
+    return group ? &group->stocks : NULL;
+}
+
+//**************************************************
+// get a window of the stocks in company order
+// The tree skips the companies before offset by their
+// number of stocks, and the walk stops at the last row
+// - input params: the row of the first stock, the most
+//                 stocks to get, and the vector to append to
+// - return the number of stocks appended
+//**************************************************
+int CompanyIndex::getRows(long long offset, int limit, vector<Stock*>& rows) const
+{
+    if (limit <= 0) {
+        return 0;
+    }
+    size_t n = rows.size();
+    size_t end = n + limit;
+    tree.inOrderFrom(offset, [&](CompanyGroup& group, long long first) {
+        vector<Stock*>& stocks = group.stocks;
+        size_t last = min(stocks.size(), static_cast<size_t>(first) + (end - rows.size()));
+        rows.insert(rows.end(), stocks.begin() + first, stocks.begin() + last);
+        return rows.size() < end;
+    });
+    return static_cast<int>(rows.size() - n);
+}
+
+//**************************************************
+// remove all the stocks of a company with one tree operation
+// - input params: the company name, and the vector
+//                 to append the removed stocks to
+// - return the number of stocks removed
+//**************************************************
+int CompanyIndex::removeCompany(string_view company, vector<Stock*>& removed)
+{
+    CompanyGroup* found = findGroup(company);
+    CompanyGroup* group = NULL;
+    if (!found || !tree.remove(*found, group)) {
+        return 0;
+    }
+
+    int n = static_cast<int>(group->stocks.size());
+    removed.insert(removed.end(), group->stocks.begin(), group->stocks.end());
+    count -= n;
+    delete group;
+
+    return n;
+}
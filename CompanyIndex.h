@@ -0,0 +1,138 @@
+// Specification file for the CompanyIndex class
+// CompanyIndex is the secondary index of the stock database by
+// company name. It is an AVL tree with one node per distinct company,
+// and each node owns a vector of the stocks of that company, sorted
+// by their unique key (symbol + date). Looking up a company costs
+// O(log companies) no matter how many stocks it has, and all the
+// stocks of a company are removed with one tree operation.
+// CompanyIndex only stores the pointers to the Stock objects
+// The lookups take the company name as a string_view and do not
+// allocate memory.
+// The weight of a tree node is the number of stocks of its company,
+// so a window of the stocks in company order is found in
+// O(log companies) from its first row.
+
+#ifndef COMPANY_INDEX_H_
+#define COMPANY_INDEX_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+using std::string;
+using std::string_view;
+using std::vector;
+
+#include "AVLTree.h"
+
+class Stock;
+
+// the stocks of one company
+struct CompanyGroup
+{
+    string company;
+    vector<Stock*> stocks;
+
+    // groups are ordered and matched by company name
+    bool operator < (const CompanyGroup& obj) const {return company < obj.company;}
+    bool operator > (const CompanyGroup& obj) const {return company > obj.company;}
+    bool operator == (const CompanyGroup& obj) const {return company == obj.company;}
+};
+
+// a group is as many rows as it has stocks
+template<>
+struct ItemWeight<CompanyGroup>
+{
+    static long long of(const CompanyGroup& group) {return static_cast<long long>(group.stocks.size());}
+};
+
+class CompanyIndex
+{
+private:
+    AVLTree<CompanyGroup> tree;   // one node per company
+    int count;                    // number of stocks
+
+public:
+    // constructor and destructor
+    CompanyIndex();
+    ~CompanyIndex();
+
+    // getters
+    int getCount() const {return count;}
+    int getNumCompanies() const {return tree.getCount();}
+    bool isEmpty() const {return count == 0;}
+
+    // insert a stock into the group of its company
+    bool insert(Stock* dataIn);
+
+    // remove the stock with the same symbol and date as key
+    // return the removed stock via output parameter
+    bool remove(const Stock& key, Stock*& dataOut);
+
+    // return the stocks of a company sorted by symbol + date,
+    // NULL if there is no such company
+    const vector<Stock*>* search(string_view company) const;
+
+    // remove all the stocks of a company and append them to removed
+    // return the number of stocks removed
+    int removeCompany(string_view company, vector<Stock*>& removed);
+
+    // visit the stocks in company order, then symbol + date order
+    template<class Visit>
+    void inOrder(Visit visit) const;
+
+    // append up to limit stocks in company order, then symbol + date
+    // order, from the stock at row offset (0 for the first stock)
+    // return the number of stocks appended
+    int getRows(long long offset, int limit, vector<Stock*>& rows) const;
+
+    // print the tree as an indented list, the stocks of
+    // a company at the level of its node
+    template<class Visit>
+    void printTree(Visit visit) const;
+
+private:
+    // compare the company names of two groups
+    static int compareGroups(const CompanyGroup& g1, const CompanyGroup& g2);
+
+    // compare the company name of a group with a company name
+    static int compareCompany(const CompanyGroup& group, const string_view& company);
+
+    // find the group of a company, NULL if none
+    CompanyGroup* findGroup(string_view company) const;
+
+    // not copyable
+    CompanyIndex(const CompanyIndex&);
+    CompanyIndex& operator=(const CompanyIndex&);
+};
+
+//**************************************************
+// visit all the stocks in company order, and the stocks
+// of a company in symbol + date order
+// - input param: the function called with each stock
+//**************************************************
+template<class Visit>
+void CompanyIndex::inOrder(Visit visit) const
+{
+    tree.inOrder([&](CompanyGroup& group) {
+        for (size_t i = 0; i < group.stocks.size(); i++) {
+            visit(*group.stocks[i]);
+        }
+    });
+}
+
+//**************************************************
+// print the tree as an indented list
+// - input param: the function called with each stock
+//                and the level of its company node
+//**************************************************
+template<class Visit>
+void CompanyIndex::printTree(Visit visit) const
+{
+    tree.printTree([&](CompanyGroup& group, int level) {
+        for (size_t i = 0; i < group.stocks.size(); i++) {
+            visit(*group.stocks[i], level);
+        }
+    });
+}
+
+#endif // COMPANY_INDEX_H_
@@ -0,0 +1,221 @@
+// Implementation file for the ConcurrentIndex class
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <string_view>
+using namespace std;
+
+#include "Stock.h"
+#include "HashPolicy.h"
+#include "ConcurrentIndex.h"
+
+// the average number of stocks in a shard, which is
+// what the writer copies to change one stock
+static const int SHARD_SIZE = 256;
+
+//**************************************************
+// the order of the key shards: by symbol + date
+//**************************************************
+static bool lessKey(const Stock* s1, const Stock* s2)
+{
+    return *s1 < *s2;
+}
+
+//**************************************************
+// the order of the company shards: by company, then symbol + date
+//**************************************************
+static bool lessCompany(const Stock* s1, const Stock* s2)
+{
+    int c = s1->getCompanyName().compare(s2->getCompanyName());
+    return c < 0 || (c == 0 && *s1 < *s2);
+}
+
+//**************************************************
+// Constructor
+// There are about n / SHARD_SIZE shards, at least 64
+// - input param: the expected number of stocks
+//**************************************************
+ConcurrentIndex::ConcurrentIndex(int n)
+    : keyShards(max(64, n / SHARD_SIZE)), companyShards(max(64, n / SHARD_SIZE))
+{
+    numShards = static_cast<int>(keyShards.size());
+    for (int i = 0; i < numShards; i++) {
+        keyShards[i].store(new Shard());
+        companyShards[i].store(new Shard());
+    }
+    count = 0;
+}
+
+//**************************************************
+// Destructor, there must be no reader left
+//**************************************************
+ConcurrentIndex::~ConcurrentIndex()
+{
+    for (int i = 0; i < numShards; i++) {
+        delete keyShards[i].load();
+        delete companyShards[i].load();
+    }
+}
+
+//**************************************************
+// the key shard of a stock, from the same hash as the HashTable
+//**************************************************
+int ConcurrentIndex::keyShardOf(const Stock& stk) const
+{
+    return WyHash<Stock>::index(WyHash<Stock>::hash(stk), numShards);
+}
+
+//**************************************************
+// the company shard of a company name
+//**************************************************
+int ConcurrentIndex::companyShardOf(string_view company) const
+{
+    return WyHash<Stock>::index(wyHashBytes(company.data(), company.size()), numShards);
+}
+
+//**************************************************
+// build the index from stocks
+// The shards are filled and sorted in place, before any
+// reader can see them
+// - input param: the stocks
+//**************************************************
+void ConcurrentIndex::build(const vector<Stock*>& stocks)
+{
+    for (size_t i = 0; i < stocks.size(); i++) {
+        keyShards[keyShardOf(*stocks[i])].load()->push_back(stocks[i]);
+        companyShards[companyShardOf(stocks[i]->getCompanyName())].load()->push_back(stocks[i]);
+    }
+    for (int i = 0; i < numShards; i++) {
+        Shard* shard = keyShards[i].load();
+        sort(shard->begin(), shard->end(), lessKey);
+        shard = companyShards[i].load();
+        sort(shard->begin(), shard->end(), lessCompany);
+    }
+    count += static_cast<int>(stocks.size());
+}
+
+//**************************************************
+// publish a new shard in place of the old one,
+// and retire the old one
+//**************************************************
+void ConcurrentIndex::publish(vector<atomic<Shard*> >& shards, int i, Shard* shard)
+{
+    Shard* old = shards[i].exchange(shard, memory_order_seq_cst);
+    epochs.retire(old);
+}
+
+//**************************************************
+// add a stock to a copy of its key shard and of its
+// company shard, and publish the copies
+// - input param: the stock
+//**************************************************
+void ConcurrentIndex::insert(Stock* stk)
+{
+    int k = keyShardOf(*stk);
+    Shard* shard = new Shard(*keyShards[k].load(memory_order_relaxed));
+    shard->insert(upper_bound(shard->begin(), shard->end(), stk, lessKey), stk);
+    publish(keyShards, k, shard);
+
+    int c = companyShardOf(stk->getCompanyName());
+    shard = new Shard(*companyShards[c].load(memory_order_relaxed));
+    shard->insert(upper_bound(shard->begin(), shard->end(), stk, lessCompany), stk);
+    publish(companyShards, c, shard);
+
+    count++;
+    epochs.reclaim();
+}
+
+//**************************************************
+// remove a stock from copies of its shards, and publish the copies
+// - input param: the stock
+// - return false if the stock is not in the index
+//**************************************************
+bool ConcurrentIndex::remove(Stock* stk)
+{
+    int k = keyShardOf(*stk);
+    const Shard* old = keyShards[k].load(memory_order_relaxed);
+    Shard::const_iterator it = find(old->begin(), old->end(), stk);
+    if (it == old->end()) {
+        return false;
+    }
+    Shard* shard = new Shard(*old);
+    shard->erase(shard->begin() + (it - old->begin()));
+    publish(keyShards, k, shard);
+
+    int c = companyShardOf(stk->getCompanyName());
+    old = companyShards[c].load(memory_order_relaxed);
+    it = find(old->begin(), old->end(), stk);
+    if (it != old->end()) {
+        shard = new Shard(*old);
+        shard->erase(shard->begin() + (it - old->begin()));
+        publish(companyShards, c, shard);
+    }
+
+    count--;
+    epochs.reclaim();
+    return true;
+}
+
+//**************************************************
+// Reader constructor, registers the reader thread
+//**************************************************
+ConcurrentIndex::Reader::Reader(const ConcurrentIndex& index) : index(index)
+{
+    slot = index.epochs.registerReader();
+}
+
+//**************************************************
+// Reader destructor, unregisters the reader thread
+//**************************************************
+ConcurrentIndex::Reader::~Reader()
+{
+    index.epochs.unregisterReader(slot);
+}
+
+//**************************************************
+// search a stock by symbol and date
+// The stock pointer stays valid after the read,
+// only the shard may be freed
+// - input params: the symbol and the date
+// - return the stock, or NULL if not found
+//**************************************************
+Stock* ConcurrentIndex::Reader::search(string_view symbol, string_view date) const
+{
+    EpochManager& epochs = index.epochs;
+    StockKey key(symbol, date);
+    int k = WyHash<Stock>::index(WyHash<Stock>::hash(key), index.numShards);
+
+    epochs.enter(slot);
+    const Shard* shard = index.keyShards[k].load(memory_order_seq_cst);
+    Shard::const_iterator it = lower_bound(shard->begin(), shard->end(), key,
+        [](const Stock* stk, const StockKey& k) {return *stk < k;});
+    Stock* found = (it != shard->end() && **it == key) ? *it : NULL;
+    epochs.leave(slot);
+
+    return found;
+}
+
+//**************************************************
+// search the stocks of a company
+// - input params: the company name, and the vector to
+//                 append the stocks found to
+// - return the number of stocks found
+//**************************************************
+int ConcurrentIndex::Reader::searchCompany(string_view company, vector<Stock*>& found) const
+{
+    EpochManager& epochs = index.epochs;
+    int c = index.companyShardOf(company);
+
+    epochs.enter(slot);
+    const Shard* shard = index.companyShards[c].load(memory_order_seq_cst);
+    Shard::const_iterator it = lower_bound(shard->begin(), shard->end(), company,
+        [](const Stock* stk, string_view name) {return stk->getCompanyName() < name;});
+    size_t n = found.size();
+    for (; it != shard->end() && (*it)->getCompanyName() == company; ++it) {
+        found.push_back(*it);
+    }
+    epochs.leave(slot);
+
+    return static_cast<int>(found.size() - n);
+}
@@ -0,0 +1,96 @@
+// Specification file for the ConcurrentIndex class
+// ConcurrentIndex lets many reader threads search the stocks by symbol
+// and date, or by company name, while one writer thread adds and
+// removes stocks. The stocks are split into shards by the hash of
+// their key (symbol + date) and, separately, by the hash of their
+// company name. A shard is an immutable vector of stock pointers,
+// sorted by key or by company name then key. The writer never changes
+// a shard that readers may see: it copies the shard, changes the copy,
+// publishes it with an atomic pointer store (read-copy-update), and
+// retires the old shard to an EpochManager, which frees it once no
+// reader can still be reading it. A reader never blocks or retries.
+// The index only stores pointers: the Stock objects must outlive it
+// and must not change while they are in it.
+
+#ifndef CONCURRENT_INDEX_H_
+#define CONCURRENT_INDEX_H_
+
+#include <atomic>
+#include <vector>
+#include <string_view>
+#include "EpochManager.h"
+using std::vector;
+using std::string_view;
+
+class Stock;
+
+class ConcurrentIndex
+{
+private:
+    // an immutable, sorted group of stocks
+    typedef vector<Stock*> Shard;
+
+    vector<std::atomic<Shard*> > keyShards;       // sorted by symbol + date
+    vector<std::atomic<Shard*> > companyShards;   // sorted by company, symbol + date
+    int numShards;
+    int count;                                    // writer only
+    mutable EpochManager epochs;                  // readers register in it
+
+public:
+    // a reader thread: registers with the index while it exists,
+    // and each search is one epoch-protected read
+    class Reader
+    {
+    private:
+        const ConcurrentIndex& index;
+        int slot;
+
+    public:
+        Reader(const ConcurrentIndex& index);
+        ~Reader();
+
+        // check if the reader got a slot
+        bool isValid() const {return slot >= 0;}
+
+        // search a stock by symbol and date, NULL if not found
+        Stock* search(string_view symbol, string_view date) const;
+
+        // append the stocks of a company to found, sorted by symbol
+        // and date, return the number of stocks found
+        int searchCompany(string_view company, vector<Stock*>& found) const;
+
+    private:
+        Reader(const Reader&);
+        Reader& operator=(const Reader&);
+    };
+
+    // create an index of about n stocks, which picks the number of shards
+    ConcurrentIndex(int n);
+    ~ConcurrentIndex();
+
+    // getters (writer only)
+    int getCount() const {return count;}
+    int getNumShards() const {return numShards;}
+    int getNumRetired() const {return epochs.getNumRetired();}
+
+    // build the index from stocks, before any reader (writer only)
+    void build(const vector<Stock*>& stocks);
+
+    // add or remove a stock and publish the shards it is in (writer only)
+    void insert(Stock* stk);
+    bool remove(Stock* stk);
+
+private:
+    // the shards of a key and of a company name
+    int keyShardOf(const Stock& stk) const;
+    int companyShardOf(string_view company) const;
+
+    // publish a new shard in place of the old one
+    void publish(vector<std::atomic<Shard*> >& shards, int i, Shard* shard);
+
+    // not copyable
+    ConcurrentIndex(const ConcurrentIndex&);
+    ConcurrentIndex& operator=(const ConcurrentIndex&);
+};
+
+#endif // CONCURRENT_INDEX_H_
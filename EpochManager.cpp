@@ -0,0 +1,97 @@
+// Implementation file for the EpochManager class
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+#include "EpochManager.h"
+
+//**************************************************
+// Constructor
+// The epochs start at 1, 0 marks a reader not in a read
+//**************************************************
+EpochManager::EpochManager()
+{
+    for (int i = 0; i < MAX_READERS; i++) {
+        slots[i].epoch.store(0);
+        slots[i].used.store(false);
+    }
+    globalEpoch.store(1);
+}
+
+//**************************************************
+// Destructor
+//**************************************************
+EpochManager::~EpochManager()
+{
+    for (size_t i = 0; i < retired.size(); i++) {
+        retired[i].free(retired[i].object);
+    }
+}
+
+//**************************************************
+// register a reader thread
+// - return its slot, or -1 if all the slots are used
+//**************************************************
+int EpochManager::registerReader()
+{
+    for (int i = 0; i < MAX_READERS; i++) {
+        bool expected = false;
+        if (!slots[i].used.load(memory_order_relaxed) &&
+            slots[i].used.compare_exchange_strong(expected, true)) {
+            slots[i].epoch.store(0);
+            return i;
+        }
+    }
+    return -1;
+}
+
+//**************************************************
+// unregister the reader thread of a slot
+//**************************************************
+void EpochManager::unregisterReader(int slot)
+{
+    if (slot >= 0 && slot < MAX_READERS) {
+        slots[slot].epoch.store(0);
+        slots[slot].used.store(false);
+    }
+}
+
+//**************************************************
+// advance the epoch and free the retired objects no reader can hold
+// An object retired in epoch E was unlinked before the epoch moved
+// past E, so a reader that entered in a later epoch cannot reach it.
+// It is freed when every reader in a read entered after E.
+// - return the number of objects freed
+//**************************************************
+int EpochManager::reclaim()
+{
+    if (retired.empty()) {
+        return 0;
+    }
+    globalEpoch.fetch_add(1, memory_order_seq_cst);
+
+    // the oldest epoch a reader is still reading in
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < MAX_READERS; i++) {
+        uint64_t e = slots[i].epoch.load(memory_order_seq_cst);
+        if (e != 0 && e < oldest) {
+            oldest = e;
+        }
+    }
+
+    int freed = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        if (retired[i].epoch < oldest) {
+            retired[i].free(retired[i].object);
+            freed++;
+        }
+        else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+    return freed;
+}
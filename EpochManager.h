@@ -0,0 +1,99 @@
+// Specification file for the EpochManager class
+// EpochManager is an epoch-based memory reclamation scheme for one
+// writer thread and many reader threads. A reader marks the start of
+// a read with the current global epoch and clears the mark at the end;
+// it never blocks and never writes shared data the writer waits on.
+// The writer unlinks an object so no new reader can reach it, then
+// retires it: the object is freed only when every reader that was in
+// a read at the time it was retired has left that read.
+// Each reader thread registers once to get its own slot.
+
+#ifndef EPOCH_MANAGER_H_
+#define EPOCH_MANAGER_H_
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+using std::vector;
+
+class EpochManager
+{
+public:
+    // the most reader threads registered at once
+    static const int MAX_READERS = 256;
+
+private:
+    // the epoch a reader entered its read with, 0 if not in a read,
+    // on its own cache line so readers do not slow each other down
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> used;
+    };
+
+    // an object waiting to be freed
+    struct Retired
+    {
+        void* object;
+        void (*free)(void*);
+        uint64_t epoch;
+    };
+
+    Slot slots[MAX_READERS];
+    std::atomic<uint64_t> globalEpoch;
+    vector<Retired> retired;   // writer only
+
+public:
+    // constructor and destructor, the destructor frees all the
+    // retired objects: there must be no reader left
+    EpochManager();
+    ~EpochManager();
+
+    // register a reader thread and return its slot,
+    // or -1 if there are MAX_READERS already
+    int registerReader();
+
+    // unregister the reader thread of a slot
+    void unregisterReader(int slot);
+
+    // start and end a read on the slot of a reader thread
+    void enter(int slot)
+    {
+        slots[slot].epoch.store(globalEpoch.load(std::memory_order_acquire),
+                                std::memory_order_seq_cst);
+    }
+    void leave(int slot)
+    {
+        slots[slot].epoch.store(0, std::memory_order_release);
+    }
+
+    // retire an object the readers can no longer reach,
+    // it is deleted once no reader can hold it (writer only)
+    template<class T>
+    void retire(T* object)
+    {
+        Retired r;
+        r.object = object;
+        r.free = &deleteObject<T>;
+        r.epoch = globalEpoch.load(std::memory_order_seq_cst);
+        retired.push_back(r);
+    }
+
+    // advance the epoch and free the retired objects
+    // no reader can hold any more (writer only)
+    // return the number of objects freed
+    int reclaim();
+
+    // number of objects waiting to be freed
+    int getNumRetired() const {return static_cast<int>(retired.size());}
+
+private:
+    template<class T>
+    static void deleteObject(void* object) {delete static_cast<T*>(object);}
+
+    // not copyable
+    EpochManager(const EpochManager&);
+    EpochManager& operator=(const EpochManager&);
+};
+
+#endif // EPOCH_MANAGER_H_
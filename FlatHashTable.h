@@ -0,0 +1,358 @@
+// Specification file for the FlatHashTable class
+// It is an open-addressing hash table with the same interface as
+// the HashTable class. The items are stored in one flat array of
+// slots and collisions are resolved by Robin Hood linear probing:
+// an item being inserted takes the slot of an item that is closer
+// to its home slot, which keeps the probe sequences short and even.
+// Removal shifts the following items back, so there are no tombstones.
+// The table never grows by itself, call rehash before it is full.
+// The HashPolicy template parameter hashes the items and reduces
+// the hash values to slot indexes (see HashPolicy.h)
+
+#ifndef FLAT_HASH_TABLE_H_
+#define FLAT_HASH_TABLE_H_
+
+#include <string>
+#include <vector>
+using std::string;
+using std::vector;
+
+#include "HashPolicy.h"
+
+template<class ItemType, class HashPolicy>
+class FlatHashTable
+{
+private:
+    // a slot of the table
+    struct Slot
+    {
+        ItemType* item;   // pointer to the item, NULL if empty
+        int dist;         // distance from the home slot of the item
+    };
+
+    const int HASH_SIZE = 101;
+    Slot* slots;
+    int hashSize;
+    int count;
+
+    // the home slot of a key in a table of the given size
+    static int h(const ItemType& key, int size)
+    {
+        return HashPolicy::index(HashPolicy::hash(key), size);
+    }
+
+public:
+    // constructors
+    FlatHashTable()
+    {
+        hashSize = HASH_SIZE;
+        slots = newSlots(hashSize);
+        count = 0;
+    }
+    FlatHashTable(int n)
+    {
+        hashSize = n;
+        slots = newSlots(hashSize);
+        count = 0;
+    }
+    ~FlatHashTable();
+
+    int getCount() const {return count;}
+    int getSize() const {return hashSize;}
+    double getLoadFactor() const {return 100.0 * count / hashSize;}
+    bool isEmpty() const {return count == 0;}
+    bool isFull() const {return count == hashSize;}
+
+    // insert, remove, search fuctions
+    bool insert(ItemType* dataIn);
+    bool remove(const ItemType &key, ItemType*& dataOut);
+    int  search(const ItemType &key, ItemType*& dataOut);
+
+    // show the statistics of the hash table
+    void showStatistics() const;
+
+    // rehash the hash table to a new size
+    bool rehash(int n);
+
+    // print the hash
+    void printHash() const;
+
+    // save the items in the hash table to a file
+    bool saveToFile(const string& filename);
+
+    // append the pointers of all the items to a vector
+    void getItems(vector<ItemType*>& items) const;
+
+private:
+    // allocate an array of n empty slots
+    static Slot* newSlots(int n);
+
+    // place an item in a slot array by Robin Hood probing
+    static void place(Slot* ary, int size, ItemType* item, int home);
+
+    // not copyable
+    FlatHashTable(const FlatHashTable&);
+    FlatHashTable& operator=(const FlatHashTable&);
+};
+
+//**************************************************
+// Destructor
+//**************************************************
+template<class ItemType, class HashPolicy>
+FlatHashTable<ItemType, HashPolicy>::~FlatHashTable()
+{
+    // delete all the items in the slot array
+    for (int i = 0; i < hashSize; i++) {
+        if (slots[i].item) {
+            delete slots[i].item;
+        }
+    }
+
+    // delete the slot array
+    delete[] slots;
+}
+
+//**************************************************
+// allocate an array of empty slots
+// - input param: the number of slots
+//**************************************************
+template<class ItemType, class HashPolicy>
+typename FlatHashTable<ItemType, HashPolicy>::Slot* FlatHashTable<ItemType, HashPolicy>::newSlots(int n)
+{
+    Slot* ary = new Slot[n];
+    for (int i = 0; i < n; i++) {
+        ary[i].item = NULL;
+        ary[i].dist = 0;
+    }
+    return ary;
+}
+
+//**************************************************
+// place an item in a slot array by Robin Hood probing
+// The item moves forward from its home slot and takes the
+// place of the first item that is closer to its own home,
+// which then moves on in the same way
+// - input params: the slot array and its size, the item
+//                 and its home slot
+//**************************************************
+template<class ItemType, class HashPolicy>
+void FlatHashTable<ItemType, HashPolicy>::place(Slot* ary, int size, ItemType* item, int home)
+{
+    int index = home;
+    int dist = 0;
+    while (ary[index].item) {
+        if (ary[index].dist < dist) {
+            // swap with the richer item
+            ItemType* tmpItem = ary[index].item;
+            int tmpDist = ary[index].dist;
+            ary[index].item = item;
+            ary[index].dist = dist;
+            item = tmpItem;
+            dist = tmpDist;
+        }
+        index = (index + 1 == size) ? 0 : index + 1;
+        dist++;
+    }
+    ary[index].item = item;
+    ary[index].dist = dist;
+}
+
+//**************************************************
+// Insert an item into the hash table
+// - input param: the pointer to the data to be inserted
+// - return true if successful, false if the table is full
+//**************************************************
+template<class ItemType, class HashPolicy>
+bool FlatHashTable<ItemType, HashPolicy>::insert(ItemType* dataIn)
+{
+    if (isFull()) {
+        return false;
+    }
+
+    place(slots, hashSize, dataIn, h(*dataIn, hashSize));
+    count++;
+
+    return true;
+}
+
+//**************************************************
+// Removes the item with the matching key from the hash table
+// - input param: target data
+// - return true if found, otherwise, false
+//   copies data in the slot to dataOut
+//**************************************************
+template<class ItemType, class HashPolicy>
+bool FlatHashTable<ItemType, HashPolicy>::remove(const ItemType &key, ItemType*& dataOut)
+{
+    int index = h(key, hashSize);
+
+    // the probe ends at an empty slot or at an item
+    // closer to its home than the key would be
+    for (int dist = 0; slots[index].item && slots[index].dist >= dist; dist++) {
+        if (*slots[index].item == key) {
+            dataOut = slots[index].item;
+
+            // shift the following items back by one slot
+            // until an empty slot or an item in its home slot
+            int next = (index + 1 == hashSize) ? 0 : index + 1;
+            while (slots[next].item && slots[next].dist > 0) {
+                slots[index].item = slots[next].item;
+                slots[index].dist = slots[next].dist - 1;
+                index = next;
+                next = (next + 1 == hashSize) ? 0 : next + 1;
+            }
+            slots[index].item = NULL;
+            slots[index].dist = 0;
+
+            count--;
+            return true;
+        }
+        index = (index + 1 == hashSize) ? 0 : index + 1;
+    }
+
+    return false;
+}
+
+//**************************************************
+//   hash search
+// - input param: target data
+//   if found:
+//      - copy data to dataOut
+//      - returns the number of collisions for this key,
+//        that is, the number of slots probed before it
+//   if not found, returns -1
+//***************************************************
+template<class ItemType, class HashPolicy>
+int FlatHashTable<ItemType, HashPolicy>::search(const ItemType &key, ItemType*& dataOut)
+{
+    int index = h(key, hashSize);
+
+    for (int dist = 0; slots[index].item && slots[index].dist >= dist; dist++) {
+        if (*slots[index].item == key) {
+            dataOut = slots[index].item;
+            return dist;
+        }
+        index = (index + 1 == hashSize) ? 0 : index + 1;
+    }
+
+    return -1;
+}
+
+//**************************************************
+// show the statistics of the hash table
+// a collision is a slot probed before the slot of an item
+//**************************************************
+template<class ItemType, class HashPolicy>
+void FlatHashTable<ItemType, HashPolicy>::showStatistics() const
+{
+    long long noCollisions = 0;
+    int maxProbe = 0;
+    int maxItems = 0;
+    for (int i = 0; i < hashSize; i++) {
+        if (slots[i].item) {
+            noCollisions += slots[i].dist;
+            int probe = slots[i].dist + 1;
+            if (maxProbe == probe) {
+                maxItems++;
+            }
+            else if (maxProbe < probe) {
+                maxProbe = probe;
+                maxItems = 1;
+            }
+        }
+    }
+
+    cout << "Load factor: " << getLoadFactor() << endl;
+    cout << "Total number of collisions: " << noCollisions << endl;
+    cout << "Length of the longest probe sequence: " << maxProbe << endl;
+    cout << "Number of items with the longest probe sequence: " << maxItems << endl;
+}
+
+//**************************************************
+// rehash the hash table to a new size
+//**************************************************
+template<class ItemType, class HashPolicy>
+bool FlatHashTable<ItemType, HashPolicy>::rehash(int n)
+{
+    if (n <= hashSize) {
+        return false;
+    }
+
+    Slot* newSlotAry = newSlots(n);
+
+    // re-insert all the items in the slot array to the new slot array
+    for (int i = 0; i < hashSize; i++) {
+        if (slots[i].item) {
+            place(newSlotAry, n, slots[i].item, h(*slots[i].item, n));
+        }
+    }
+
+    // delete the old slot array
+    delete [] slots;
+
+    // update new slot array and hash size
+    slots = newSlotAry;
+    hashSize = n;
+
+    return true;
+}
+
+//**************************************************
+// print the contents of the hash table
+//**************************************************
+template<class ItemType, class HashPolicy>
+void FlatHashTable<ItemType, HashPolicy>::printHash() const
+{
+    cout << "Hash size: " << hashSize << endl;
+    for (int i = 0; i < hashSize; i++) {
+        if (slots[i].item) {
+            cout << "Hash index: " << i << ", ";
+            cout << "Distance from home: " << slots[i].dist << endl;
+            cout << *slots[i].item;
+        }
+    }
+}
+
+//**************************************************
+// save the items in the hash table to a file
+// - input param: output filename
+// - return true if successful, otherwise, false
+//**************************************************
+template<class ItemType, class HashPolicy>
+bool FlatHashTable<ItemType, HashPolicy>::saveToFile(const string& filename)
+{
+    // open an output file to write
+    ofstream outFile(filename);
+    if (outFile.fail()) {
+        return false;
+    }
+
+    // write all the items in slot order to an output file
+    for (int i = 0; i < hashSize; i++) {
+        if (slots[i].item) {
+            outFile << *slots[i].item;
+        }
+    }
+
+    // close the file handle
+    outFile.close();
+
+    return true;
+}
+
+//**************************************************
+// append the pointers of all the items in the hash table
+// to a vector, in slot order
+// - input param: the vector to append to
+//**************************************************
+template<class ItemType, class HashPolicy>
+void FlatHashTable<ItemType, HashPolicy>::getItems(vector<ItemType*>& items) const
+{
+    for (int i = 0; i < hashSize; i++) {
+        if (slots[i].item) {
+            items.push_back(slots[i].item);
+        }
+    }
+}
+
+#endif // FLAT_HASH_TABLE_H_
@@ -24,22 +24,26 @@ public:
     int getOccupied() const {return occupied;}
     int getNoCollisions() const {return noCollisions;}
 
-    // other functions
-    bool addItem(ItemType*);
-    bool deleteItem(const ItemType&, ItemType*&);
-    bool searchItem(const ItemType&, ItemType*&);
+    // other functions, the list nodes come from the
+    // node pool if there is one, otherwise from new
+    bool addItem(ItemType*, ObjectPool<ListNode<ItemType> >* pool = NULL);
+    template<class Key> bool deleteItem(const Key&, ItemType*&,
+                                        ObjectPool<ListNode<ItemType> >* pool = NULL);
+    template<class Key> bool searchItem(const Key&, ItemType*&);
+    void clear(ObjectPool<ListNode<ItemType> >* pool = NULL);
 };
 
 //**************************************************
 // Add an item to the item list of the hash node
-// - input param: the pointer to the data to be inserted
+// - input params: the pointer to the data to be inserted,
+//                 and the node pool
 // - return true 
 //**************************************************
 template<class ItemType>
-bool HashNode<ItemType>::addItem(ItemType* dataIn)
+bool HashNode<ItemType>::addItem(ItemType* dataIn, ObjectPool<ListNode<ItemType> >* pool)
 {
     // add the item to the list    
-    items.insertNode(dataIn);
+    items.insertNode(dataIn, pool);
 
     if (!occupied) {
         // first item in the list
@@ -54,12 +58,14 @@ bool HashNode<ItemType>::addItem(ItemType* dataIn)
 
 //**************************************************
 // Delete an item from the item list of the hash node
-// - input param: target data
+// - input params: target data, and the node pool
 // - return true if found, otherwise false
 //   return the data found via output parameter
 //**************************************************
 template<class ItemType>
-bool HashNode<ItemType>::deleteItem(const ItemType& target, ItemType*& dataOut)
+template<class Key>
+bool HashNode<ItemType>::deleteItem(const Key& target, ItemType*& dataOut,
+                                    ObjectPool<ListNode<ItemType> >* pool)
 {
     // the hash node is empty
     if (!occupied) {
@@ -67,7 +73,7 @@ bool HashNode<ItemType>::deleteItem(const ItemType& target, ItemType*& dataOut)
     }
 
     // delete the item from the list
-    if (items.deleteNode(target, dataOut)) {
+    if (items.deleteNode(target, dataOut, pool)) {
         if (noCollisions > 0) {
             noCollisions--;
         }
@@ -88,7 +94,8 @@ bool HashNode<ItemType>::deleteItem(const ItemType& target, ItemType*& dataOut)
 //   return the data found via output parameter
 //**************************************************
 template<class ItemType>
-bool HashNode<ItemType>::searchItem(const ItemType& target, ItemType*& dataOut)
+template<class Key>
+bool HashNode<ItemType>::searchItem(const Key& target, ItemType*& dataOut)
 {
     // the hash node is empty
     if (!occupied) {
@@ -103,4 +110,16 @@ bool HashNode<ItemType>::searchItem(const ItemType& target, ItemType*& dataOut)
     return false;
 }
 
+//**************************************************
+// Delete all the list nodes of the hash node, but not the items
+// - input param: the node pool
+//**************************************************
+template<class ItemType>
+void HashNode<ItemType>::clear(ObjectPool<ListNode<ItemType> >* pool)
+{
+    items.clear(pool);
+    occupied = 0;
+    noCollisions = 0;
+}
+
 #endif // HASH_NODE_H_
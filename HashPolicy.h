@@ -0,0 +1,157 @@
+// Specification file for the hash policies
+// A hash policy tells HashTable and FlatHashTable how to hash an item.
+// It is a class with two static functions:
+//   uint64_t hash(const ItemType& key)  - the hash value of the key
+//   int index(uint64_t h, int size)     - reduce a hash value to [0, size)
+// WyHash hashes the packed 64-bit key of the item (getKey) when it
+// has one, otherwise the symbol and the parsed date (getDays), or the
+// date string if it cannot be parsed. Its hash is a
+// template, so it also hashes lookup keys (e.g. StockKey) that have
+// the same getters, to the same value as the item.
+// CharSumHash always sums the unique key string.
+
+#ifndef HASH_POLICY_H_
+#define HASH_POLICY_H_
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+using std::string;
+using std::string_view;
+
+//**************************************************
+// CharSumHash: the sum of the characters of the key,
+// reduced by modulo the table size
+// Keys with the same characters in any order collide,
+// and the sums only cover a small range of indexes.
+//**************************************************
+template<class ItemType>
+struct CharSumHash
+{
+    static uint64_t hash(const ItemType& key)
+    {
+        string k = key.getUniqueKey();
+        uint64_t sum = 0;
+        for (size_t i = 0; i < k.size(); i++) {
+            sum += k[i];
+        }
+        return sum;
+    }
+
+    static int index(uint64_t h, int size)
+    {
+        return static_cast<int>(h % size);
+    }
+};
+
+//**************************************************
+// 64x64 to 128 bit multiply, returns the high 64 bits
+// and the low 64 bits in lo
+//**************************************************
+inline uint64_t mulHigh(uint64_t a, uint64_t b, uint64_t& lo)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    lo = static_cast<uint64_t>(r);
+    return static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t aLo = a & 0xffffffffULL, aHi = a >> 32;
+    uint64_t bLo = b & 0xffffffffULL, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    uint64_t mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+    lo = (mid << 32) | (ll & 0xffffffffULL);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+//**************************************************
+// multiply two 64-bit values and fold the 128-bit product
+//**************************************************
+inline uint64_t wyMix(uint64_t a, uint64_t b)
+{
+    uint64_t lo;
+    uint64_t hi = mulHigh(a, b, lo);
+    return hi ^ lo;
+}
+
+//**************************************************
+// wyhash-style hash of a block of bytes
+// - input params: the bytes, their count, and a seed
+//**************************************************
+inline uint64_t wyHashBytes(const char* p, size_t len, uint64_t seed = 0)
+{
+    const uint64_t P0 = 0xa0761d6478bd642fULL;
+    const uint64_t P1 = 0xe7037ed1a0b428dbULL;
+    const uint64_t P2 = 0x8ebc6af09c88c6e3ULL;
+
+    seed ^= P0;
+    size_t i = len;
+    uint64_t a, b;
+    while (i > 16) {
+        memcpy(&a, p, 8);
+        memcpy(&b, p + 8, 8);
+        seed = wyMix(a ^ P1, b ^ seed);
+        p += 16;
+        i -= 16;
+    }
+    if (i > 8) {
+        memcpy(&a, p, 8);
+        memcpy(&b, p + i - 8, 8);
+    }
+    else if (i >= 4) {
+        uint32_t x, y;
+        memcpy(&x, p, 4);
+        memcpy(&y, p + i - 4, 4);
+        a = x;
+        b = y;
+    }
+    else if (i > 0) {
+        a = (static_cast<uint64_t>(static_cast<unsigned char>(p[0])) << 16) |
+            (static_cast<uint64_t>(static_cast<unsigned char>(p[i >> 1])) << 8) |
+            static_cast<unsigned char>(p[i - 1]);
+        b = 0;
+    }
+    else {
+        a = b = 0;
+    }
+    return wyMix(P1 ^ len, wyMix(a ^ P1, b ^ seed ^ P2));
+}
+
+//**************************************************
+// WyHash: a fast, well distributed 64-bit hash of the key,
+// reduced by multiply-shift (the high 64 bits of hash * size),
+// which maps the hash evenly to any table size without a division
+// A packed key is mixed directly, otherwise the symbol is hashed
+// and seeds the hash of the days, so equal dates written differently
+// hash alike, or of the date string if it cannot be parsed
+//**************************************************
+template<class ItemType>
+struct WyHash
+{
+    template<class Key>
+    static uint64_t hash(const Key& key)
+    {
+        uint64_t packed = key.getKey();
+        if (packed) {
+            return wyMix(packed ^ 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL);
+        }
+        string_view symbol = key.getSymbol();
+        uint64_t seed = wyHashBytes(symbol.data(), symbol.size());
+        int days = key.getDays();
+        if (days != INT_MIN) {
+            return wyHashBytes(reinterpret_cast<const char*>(&days), sizeof(days), seed);
+        }
+        string_view date = key.getDate();
+        return wyHashBytes(date.data(), date.size(), seed);
+    }
+
+    static int index(uint64_t h, int size)
+    {
+        uint64_t lo;
+        return static_cast<int>(mulHigh(h, static_cast<uint64_t>(size), lo));
+    }
+};
+
+#endif // HASH_POLICY_H_
@@ -1,92 +1,323 @@
 // Specification file for the HashTable class
 // It is the hash table class which contains an array of HashNodes
+// The HashPolicy template parameter hashes the items and reduces
+// the hash values to bucket indexes (see HashPolicy.h)
+// Rehashing is incremental: the old bucket array is kept while a few
+// of its buckets are moved to the new array on every insert, remove
+// and search, so no single operation pays for the whole table.
+// The table grows when it holds more than 75 items per 100 buckets
+// and shrinks when it holds fewer than 15, down to its initial size.
+// remove and search take the item type or any lookup key that the
+// hash policy can hash and the items compare with (e.g. StockKey),
+// so a lookup does not need to build a whole item.
+// searchBatch looks up many keys at once: a group of keys is hashed
+// and their buckets prefetched before any of them is searched, so
+// the cache misses of the group overlap instead of following one
+// another. findBatch does the same without moving old buckets, so
+// several threads can search parts of one batch at a time.
+// The items and the list nodes can come from object pools (setPools),
+// which the destructor returns them to instead of deleting them.
 //
 
 #ifndef HASH_TABLE_H_
 #define HASH_TABLE_H_
 
 #include <string>
+#include <vector>
 using std::string;
+using std::vector;
 
 #include "HashNode.h"
+#include "HashPolicy.h"
+#include "Utils.h"
 
-template<class ItemType>
+template<class ItemType, class HashPolicy>
 class HashTable
 {
 private:
     const int HASH_SIZE = 101;
+    // the number of old buckets moved per operation while rehashing
+    static const int REHASH_STEP = 4;
+    // grow above and shrink below these loads (items per 100 buckets)
+    static const int MAX_LOAD = 75;
+    static const int MIN_LOAD = 15;
+    // the number of keys of a batch that are prefetched together
+    static const int BATCH_GROUP = 16;
     HashNode<ItemType>* hashAry;
     int hashSize;
-    int count;
-
-    // hash function pointer
-    int (*h)(const ItemType& key, int size);
+    int minSize;      // the table does not shrink below this size
+    int reserved;     // items reserve() made room for, 0 if none: the
+                      // table does not shrink until they are all in
+    int count;        // number of items
+    int occupied;     // number of occupied buckets
+
+    // the old bucket array while rehashing, NULL otherwise
+    // the old buckets below migrateIndex have been moved
+    HashNode<ItemType>* oldAry;
+    int oldSize;
+    int migrateIndex;
+
+    // the pools of the items and the list nodes, NULL to use new and delete
+    ObjectPool<ItemType>* itemPool;
+    ObjectPool<ListNode<ItemType> >* nodePool;
+
+    // the bucket index of a key in a table of the given size
+    static int h(const ItemType& key, int size)
+    {
+        return HashPolicy::index(HashPolicy::hash(key), size);
+    }
 
 public:
-    // the constructor takes a hash function pointer
-    // used by the hash table
-    HashTable(int hf(const ItemType& key, int size)) 
+    // constructors
+    HashTable() 
     {
         hashSize = HASH_SIZE; 
         hashAry = new HashNode<ItemType>[hashSize];
+        minSize = hashSize;
+        reserved = 0;
         count = 0; 
-        h = hf;
+        occupied = 0;
+        oldAry = NULL;
+        oldSize = 0;
+        migrateIndex = 0;
+        itemPool = NULL;
+        nodePool = NULL;
     }
-    HashTable(int n, int hf(const ItemType& key, int size))
+    HashTable(int n)
     {
         hashSize = n; 
         hashAry = new HashNode<ItemType>[hashSize];
+        minSize = hashSize;
+        reserved = 0;
         count = 0; 
-        h = hf;
+        occupied = 0;
+        oldAry = NULL;
+        oldSize = 0;
+        migrateIndex = 0;
+        itemPool = NULL;
+        nodePool = NULL;
     }
     ~HashTable();
 
     int getCount() const {return count;}
+    int getOccupied() const {return occupied;}
     int getSize() const {return hashSize;}
     double getLoadFactor() const {return 100.0 * count / hashSize;}
     bool isEmpty() const {return count == 0;}
     bool isFull() const {return count == hashSize;}
+    bool isRehashing() const {return oldAry != NULL;}
+
+    // set the pools the items come from and the list nodes are
+    // created in, before the first insert; the pools must outlive the table
+    void setPools(ObjectPool<ItemType>* items, ObjectPool<ListNode<ItemType> >* nodes)
+    {
+        itemPool = items;
+        nodePool = nodes;
+    }
     
     // insert, remove, search fuctions
     bool insert(ItemType* dataIn);
-    bool remove(const ItemType &key, ItemType*& dataOut);
-    int  search(const ItemType &key, ItemType*& dataOut);
+    template<class Key> bool remove(const Key &key, ItemType*& dataOut);
+    template<class Key> int  search(const Key &key, ItemType*& dataOut);
+
+    // search n keys, found[i] is set to the item of keys[i] or NULL
+    // return the number of keys found
+    template<class Key> int searchBatch(const Key* keys, int n, ItemType** found);
+
+    // searchBatch without moving old buckets, so it does not change
+    // the table and threads can call it at the same time
+    template<class Key> int findBatch(const Key* keys, int n, ItemType** found) const;
 
     // show the statistics of the hash table
     void showStatistics() const;
 
-    // rehash the hash table to a new size
+    // show how the items would be distributed over the
+    // buckets by another hash policy, for comparison
+    template<class OtherPolicy>
+    void showDistribution(const string& name) const;
+
+    // start rehashing the hash table to a new size
     bool rehash(int n);
 
+    // move all the remaining old buckets to the new array
+    void finishRehash();
+
+    // make room for n items, e.g. before a bulk load
+    bool reserve(int n);
+
     // print the hash
     void printHash() const;
 
     // save the items in the hash table to a file
     bool saveToFile(const string& filename); 
+
+    // append the pointers of all the items to a vector
+    void getItems(vector<ItemType*>& items) const;
+
+private:
+    // the bucket that holds a key: the old bucket if it
+    // has not been moved yet, otherwise the new bucket
+    template<class Key> HashNode<ItemType>& bucket(const Key& key) const;
+
+    // move up to n old buckets to the new array
+    void migrate(int n);
+
+    // start growing or shrinking the table if its load is out of bounds
+    void resize();
+
+    // call a function on every item in both bucket arrays
+    template<class Func>
+    void forEachItem(Func func) const;
+
+    // not copyable
+    HashTable(const HashTable&);
+    HashTable& operator=(const HashTable&);
 };
 
 //**************************************************
 // Destructor
 //**************************************************
-template<class ItemType>
-HashTable<ItemType>::~HashTable() 
+template<class ItemType, class HashPolicy>
+HashTable<ItemType, HashPolicy>::~HashTable() 
 {
-    // delete all the items in the hash array
-    for (int i = 0; i < hashSize; i++) {
-        if (hashAry[i].getOccupied()) {
-            const LinkedList<ItemType>& items = hashAry[i].getItems();
-            const ListNode<ItemType>* cur = items.getHead()->getNext();
-            while (cur) {
-                ItemType* item = cur->getItem();
-                // free item object
-                delete item;
-                cur = cur->getNext();
-            }
+    // delete all the items in the hash arrays
+    forEachItem([this](ItemType* item) {
+        // free item object
+        if (itemPool) {
+            itemPool->destroy(item);
+        }
+        else {
+            delete item;
+        }
+    });
+
+    // return the list nodes to their pool
+    if (nodePool) {
+        for (int i = 0; i < hashSize; i++) {
+            hashAry[i].clear(nodePool);
+        }
+        for (int i = 0; oldAry && i < oldSize; i++) {
+            oldAry[i].clear(nodePool);
         }
     }
 
-    // delete the hash array
+    // delete the hash arrays
     delete[] hashAry; 
+    delete[] oldAry;
+}
+
+//**************************************************
+// find the bucket that holds a key
+// While rehashing, the old buckets are moved in index order,
+// so a key is in its old bucket until that bucket is moved
+// - input param: the key
+// - return the bucket
+//**************************************************
+template<class ItemType, class HashPolicy>
+template<class Key>
+HashNode<ItemType>& HashTable<ItemType, HashPolicy>::bucket(const Key& key) const
+{
+    uint64_t hv = HashPolicy::hash(key);
+    if (oldAry) {
+        int oldIndex = HashPolicy::index(hv, oldSize);
+        if (oldIndex >= migrateIndex) {
+            return oldAry[oldIndex];
+        }
+    }
+    return hashAry[HashPolicy::index(hv, hashSize)];
+}
+
+//**************************************************
+// move up to n old buckets to the new bucket array,
+// and delete the old array when all are moved
+// - input param: the number of old buckets to move
+//**************************************************
+template<class ItemType, class HashPolicy>
+void HashTable<ItemType, HashPolicy>::migrate(int n)
+{
+    if (!oldAry) {
+        return;
+    }
+
+    for (; n > 0 && migrateIndex < oldSize; n--, migrateIndex++) {
+        HashNode<ItemType>& old = oldAry[migrateIndex];
+        if (!old.getOccupied()) {
+            continue;
+        }
+        // the old bucket is counted again if its items
+        // land in empty new buckets
+        occupied--;
+        // the list is sorted, so removing the first item is O(1)
+        while (old.getOccupied()) {
+            ItemType* item = old.getItems().getHead()->getNext()->getItem();
+            ItemType* dataOut;
+            old.deleteItem(*item, dataOut, nodePool);
+            int index = h(*item, hashSize);
+            if (!hashAry[index].getOccupied()) {
+                occupied++;
+            }
+            hashAry[index].addItem(item, nodePool);
+        }
+    }
+
+    if (migrateIndex == oldSize) {
+        delete[] oldAry;
+        oldAry = NULL;
+        oldSize = 0;
+        migrateIndex = 0;
+    }
+}
+
+//**************************************************
+// start growing the table to twice its size if the load is over
+// MAX_LOAD, or shrinking it to two buckets per item if the load is
+// under MIN_LOAD. The gap between the two keeps the table from
+// resizing back and forth. Nothing is started while a rehash is
+// in progress, and the table does not shrink while it fills up
+// to the count passed to reserve.
+//**************************************************
+template<class ItemType, class HashPolicy>
+void HashTable<ItemType, HashPolicy>::resize()
+{
+    if (oldAry) {
+        return;
+    }
+
+    if (count >= reserved) {
+        reserved = 0;
+    }
+
+    long long load = 100LL * count;
+    if (load > static_cast<long long>(MAX_LOAD) * hashSize) {
+        rehash(nextPrime(2 * hashSize));
+    }
+    else if (!reserved && hashSize > minSize && load < static_cast<long long>(MIN_LOAD) * hashSize) {
+        int n = nextPrime(2 * count);
+        rehash(n < minSize ? minSize : n);
+    }
+}
+
+//**************************************************
+// call a function on every item in both bucket arrays
+// - input param: the function, called with the item pointer
+//**************************************************
+template<class ItemType, class HashPolicy>
+template<class Func>
+void HashTable<ItemType, HashPolicy>::forEachItem(Func func) const
+{
+    for (int a = 0; a < 2; a++) {
+        const HashNode<ItemType>* ary = (a == 0) ? oldAry : hashAry;
+        int size = (a == 0) ? oldSize : hashSize;
+        for (int i = 0; ary && i < size; i++) {
+            if (ary[i].getOccupied()) {
+                const ListNode<ItemType>* cur = ary[i].getItems().getHead()->getNext();
+                while (cur) {
+                    func(cur->getItem());
+                    cur = cur->getNext();
+                }
+            }
+        }
+    }
 }
 
 //**************************************************
@@ -94,19 +325,24 @@ HashTable<ItemType>::~HashTable()
 // - input param: the pointer to the data to be inserted
 // - return true 
 //**************************************************
-template<class ItemType>
-bool HashTable<ItemType>::insert(ItemType* dataIn)
+template<class ItemType, class HashPolicy>
+bool HashTable<ItemType, HashPolicy>::insert(ItemType* dataIn)
 {
-    // get the index to the hash table from the key 
-    int index = h(*dataIn, hashSize);
+    migrate(REHASH_STEP);
+
+    // get the hash node from the key 
+    HashNode<ItemType>& node = bucket(*dataIn);
     
-    if (!hashAry[index].getOccupied()) {
+    if (!node.getOccupied()) {
         // first insertion for the index
-        count++;
+        occupied++;
     }
 
     // add the item to the item list of the hash node
-    hashAry[index].addItem(dataIn);
+    node.addItem(dataIn, nodePool);
+    count++;
+
+    resize();
 
     return true;
 }
@@ -117,18 +353,26 @@ bool HashTable<ItemType>::insert(ItemType* dataIn)
 // - return true if found, otherwise, false
 //   copies data in the hash node to dataOut
 //**************************************************
-template<class ItemType>
-bool HashTable<ItemType>::remove(const ItemType &key, ItemType*& dataOut)
+template<class ItemType, class HashPolicy>
+template<class Key>
+bool HashTable<ItemType, HashPolicy>::remove(const Key &key, ItemType*& dataOut)
 {
-    // get the index to the hash table from the key 
-    int index = h(key, hashSize);
+    migrate(REHASH_STEP);
+
+    // get the hash node from the key 
+    HashNode<ItemType>& node = bucket(key);
 
     // delete the item from the item list of the hash node
-    if (hashAry[index].deleteItem(key, dataOut)) {
-        if (!hashAry[index].getOccupied()) {
+    if (node.deleteItem(key, dataOut, nodePool)) {
+        if (!node.getOccupied()) {
             // the hash node has no item
-            count--;
+            occupied--;
         }
+        count--;
+
+        // the table is no longer filling up to the reserved count
+        reserved = 0;
+        resize();
         return true;
     }
 
@@ -143,92 +387,240 @@ bool HashTable<ItemType>::remove(const ItemType &key, ItemType*& dataOut)
 //      - returns the number of collisions for this key
 //   if not found, returns -1
 //***************************************************
-template<class ItemType>
-int HashTable<ItemType>::search(const ItemType &key, ItemType*& dataOut)
+template<class ItemType, class HashPolicy>
+template<class Key>
+int HashTable<ItemType, HashPolicy>::search(const Key &key, ItemType*& dataOut)
 {
-    // get the index to the hash table from the key 
-    int index = h(key, hashSize);
+    migrate(REHASH_STEP);
+
+    // get the hash node from the key 
+    HashNode<ItemType>& node = bucket(key);
 
     // search the item from the item list of the hash node
-    if (hashAry[index].searchItem(key, dataOut)) {
-   	int nCol = hashAry[index].getNoCollisions();
+    if (node.searchItem(key, dataOut)) {
+   	int nCol = node.getNoCollisions();
         return nCol;
     }
 
     return -1;
 }
 
+//**************************************************
+// search a batch of keys
+// - input params: the keys, their number, and the array
+//                 of n item pointers to fill
+// - return the number of keys found, found[i] is the
+//   item of keys[i], or NULL if it is not found
+//**************************************************
+template<class ItemType, class HashPolicy>
+template<class Key>
+int HashTable<ItemType, HashPolicy>::searchBatch(const Key* keys, int n, ItemType** found)
+{
+    migrate(REHASH_STEP);
+    return findBatch(keys, n, found);
+}
+
+//**************************************************
+// search a batch of keys, BATCH_GROUP keys at a time
+// A search reads the bucket, then its first list node, then
+// the item the node points to, each a likely cache miss. The
+// keys of a group are hashed and their buckets prefetched,
+// then their first list nodes, then their first items, so the
+// misses of the group overlap, and the group is searched last.
+// - input params: the keys, their number, and the array
+//                 of n item pointers to fill
+// - return the number of keys found, found[i] is the
+//   item of keys[i], or NULL if it is not found
+//**************************************************
+template<class ItemType, class HashPolicy>
+template<class Key>
+int HashTable<ItemType, HashPolicy>::findBatch(const Key* keys, int n, ItemType** found) const
+{
+    const HashNode<ItemType>* nodes[BATCH_GROUP];
+    int numFound = 0;
+
+    for (int first = 0; first < n; first += BATCH_GROUP) {
+        int m = (n - first < BATCH_GROUP) ? n - first : BATCH_GROUP;
+
+        // hash the keys and prefetch their buckets
+        for (int i = 0; i < m; i++) {
+            nodes[i] = &bucket(keys[first + i]);
+            prefetch(nodes[i]);
+        }
+
+        // prefetch the first list node of each bucket
+        for (int i = 0; i < m; i++) {
+            const ListNode<ItemType>* cur = nodes[i]->getItems().getHead()->getNext();
+            if (cur) {
+                prefetch(cur);
+            }
+        }
+
+        // prefetch the first item of each bucket
+        for (int i = 0; i < m; i++) {
+            const ListNode<ItemType>* cur = nodes[i]->getItems().getHead()->getNext();
+            if (cur) {
+                prefetch(cur->getItem());
+            }
+        }
+
+        // search the buckets
+        for (int i = 0; i < m; i++) {
+            ItemType* dataOut = NULL;
+            if (!nodes[i]->getOccupied() ||
+                !nodes[i]->getItems().searchList(keys[first + i], dataOut)) {
+                dataOut = NULL;
+            }
+            found[first + i] = dataOut;
+            if (dataOut) {
+                numFound++;
+            }
+        }
+    }
+
+    return numFound;
+}
+
 //**************************************************
 // show the statistics of the hash table
 //**************************************************
-template<class ItemType>
-void HashTable<ItemType>::showStatistics() const
+template<class ItemType, class HashPolicy>
+void HashTable<ItemType, HashPolicy>::showStatistics() const
 {
     int noCollisions = 0;
     int maxItems = 0;
     int maxNodes = 0;
-    for (int i = 0; i < hashSize; i++) {
-        if (hashAry[i].getOccupied()) {
-            if (hashAry[i].getNoCollisions() > 0) {
-                noCollisions += hashAry[i].getNoCollisions();
-            }
-            int noItems = hashAry[i].getItems().getLength();
-            if (noItems) {
-                if (maxItems == noItems) {
-                    maxNodes++;
+    for (int a = 0; a < 2; a++) {
+        const HashNode<ItemType>* ary = (a == 0) ? oldAry : hashAry;
+        int size = (a == 0) ? oldSize : hashSize;
+        for (int i = 0; ary && i < size; i++) {
+            if (ary[i].getOccupied()) {
+                if (ary[i].getNoCollisions() > 0) {
+                    noCollisions += ary[i].getNoCollisions();
                 }
-                else if (maxItems < noItems) {
-                    maxItems = noItems;
-                    maxNodes = 1;
+                int noItems = ary[i].getItems().getLength();
+                if (noItems) {
+                    if (maxItems == noItems) {
+                        maxNodes++;
+                    }
+                    else if (maxItems < noItems) {
+                        maxItems = noItems;
+                        maxNodes = 1;
+                    }
                 }
             }
         }
     }
 
+    if (oldAry) {
+        cout << "Rehashing: " << migrateIndex << " of " << oldSize
+             << " old buckets moved" << endl;
+    }
     cout << "Load factor: " << getLoadFactor() << endl;
+    cout << "Occupied buckets: " << occupied << " of " << hashSize << endl;
     cout << "Total number of collisions: " << noCollisions << endl;
     cout << "Length of the longest linked list: " << maxItems << endl;
     cout << "Number of linked lists with the longest length: " << maxNodes << endl;
 }
 
 //**************************************************
-// rehash the hash table to a new size
+// show how the items of the hash table would be distributed
+// over the same number of buckets by another hash policy
+// - input param: the name of the other policy to display
 //**************************************************
-template<class ItemType>
-bool HashTable<ItemType>::rehash(int n)
+template<class ItemType, class HashPolicy>
+template<class OtherPolicy>
+void HashTable<ItemType, HashPolicy>::showDistribution(const string& name) const
 {
-    if (n <= hashSize) {
-        return false;
-    }
-
-    HashNode<ItemType>* newHashAry = new HashNode<ItemType>[n];
-    int cnt = 0;
-
-    // re-insert all the items in the hash array to the new hash array
+    vector<int> lengths(hashSize, 0);
+    int noItems = 0;
+    int size = hashSize;
+    forEachItem([&](ItemType* item) {
+        lengths[OtherPolicy::index(OtherPolicy::hash(*item), size)]++;
+        noItems++;
+    });
+
+    int noOccupied = 0;
+    int maxItems = 0;
+    int maxNodes = 0;
     for (int i = 0; i < hashSize; i++) {
-        if (hashAry[i].getOccupied()) {
-            const LinkedList<ItemType>& items = hashAry[i].getItems();
-            const ListNode<ItemType>* cur = items.getHead()->getNext();   
-            while (cur) {
-                ItemType* item = cur->getItem();
-                int index = h(*item, n);
-                if (!newHashAry[index].getOccupied()) {
-                    // first insertion for the index
-                    cnt++;
-                }
-                newHashAry[index].addItem(item);
-                cur = cur->getNext();
+        if (lengths[i]) {
+            noOccupied++;
+            if (maxItems == lengths[i]) {
+                maxNodes++;
+            }
+            else if (maxItems < lengths[i]) {
+                maxItems = lengths[i];
+                maxNodes = 1;
             }
         }
     }
 
-    // delete the old hash node array
-    delete [] hashAry;
+    cout << name << ": "
+         << "occupied buckets " << noOccupied << ", "
+         << "collisions " << noItems - noOccupied << ", "
+         << "longest list " << maxItems << " (" << maxNodes << " lists)" << endl;
+}
 
-    // update new hash node array, hash size and count
-    hashAry = newHashAry;
+//**************************************************
+// start rehashing the hash table to a new size, larger or smaller
+// The current array becomes the old array, and its buckets
+// are moved to the new array by the following operations.
+// A rehash still in progress is finished first.
+//**************************************************
+template<class ItemType, class HashPolicy>
+bool HashTable<ItemType, HashPolicy>::rehash(int n)
+{
+    if (n <= 0 || n == hashSize) {
+        return false;
+    }
+
+    finishRehash();
+
+    // keep the current array as the old array,
+    // occupied still covers its occupied buckets
+    oldAry = hashAry;
+    oldSize = hashSize;
+    migrateIndex = 0;
+
+    // update new hash node array and hash size
+    hashAry = new HashNode<ItemType>[n];
     hashSize = n;
-    count = cnt;
+
+    return true;
+}
+
+//**************************************************
+// move all the remaining old buckets to the new array
+//**************************************************
+template<class ItemType, class HashPolicy>
+void HashTable<ItemType, HashPolicy>::finishRehash()
+{
+    if (oldAry) {
+        migrate(oldSize - migrateIndex);
+    }
+}
+
+//**************************************************
+// make room for n items: the table is rehashed at once to about
+// two buckets per item if it is smaller than that, so a bulk load
+// of n items neither grows the table nor migrates buckets
+// The table does not shrink until it holds n items or an item is
+// removed, then it shrinks as usual
+// - input param: the number of items
+// - return true if the table was rehashed, otherwise, false
+//**************************************************
+template<class ItemType, class HashPolicy>
+bool HashTable<ItemType, HashPolicy>::reserve(int n)
+{
+    int size = nextPrime(2 * n);
+    if (size <= hashSize) {
+        return false;
+    }
+
+    reserved = n;
+    rehash(size);
+    finishRehash();
 
     return true;
 }
@@ -236,9 +628,20 @@ bool HashTable<ItemType>::rehash(int n)
 //**************************************************
 // print the contents of the hash table
 //**************************************************
-template<class ItemType>
-void HashTable<ItemType>::printHash() const
+template<class ItemType, class HashPolicy>
+void HashTable<ItemType, HashPolicy>::printHash() const
 {
+    if (oldAry) {
+        cout << "Old hash size: " << oldSize << endl;
+        for (int i = migrateIndex; i < oldSize; i++) {
+            if (oldAry[i].getOccupied()) {
+                cout << "Old hash index: " << i << ", ";
+                cout << "No. collisions: " << oldAry[i].getNoCollisions() << endl;
+                oldAry[i].getItems().displayList();
+            }
+        }
+    }
+
     cout << "Hash size: " << hashSize << endl;
     for (int i = 0; i < hashSize; i++) {
         if (hashAry[i].getOccupied()) {
@@ -254,8 +657,8 @@ void HashTable<ItemType>::printHash() const
 // - input param: output filename
 // - return true if successful, otherwise, false
 //**************************************************
-template<class ItemType>
-bool HashTable<ItemType>::saveToFile(const string& filename)
+template<class ItemType, class HashPolicy>
+bool HashTable<ItemType, HashPolicy>::saveToFile(const string& filename)
 {
     // open an output file to write
     ofstream outFile(filename);
@@ -263,19 +666,11 @@ bool HashTable<ItemType>::saveToFile(const string& filename)
         return false;
     }
 
-    // iterate through all the items in the hash array and write
+    // iterate through all the items in the hash arrays and write
     // them to an output file
-    for (int i = 0; i < hashSize; i++) {
-        if (hashAry[i].getOccupied()) {
-            const LinkedList<ItemType>& items = hashAry[i].getItems();
-            const ListNode<ItemType>* cur = items.getHead()->getNext();
-            while (cur) {
-                ItemType* item = cur->getItem();
-                outFile << (*item);
-                cur = cur->getNext();
-            }
-        }
-    }
+    forEachItem([&](ItemType* item) {
+        outFile << (*item);
+    });
 
     // close the file handle
     outFile.close();
@@ -283,5 +678,17 @@ bool HashTable<ItemType>::saveToFile(const string& filename)
     return true;
 }
 
+//**************************************************
+// append the pointers of all the items in the hash table
+// to a vector, in bucket order (old buckets first while rehashing)
+// - input param: the vector to append to
+//**************************************************
+template<class ItemType, class HashPolicy>
+void HashTable<ItemType, HashPolicy>::getItems(vector<ItemType*>& items) const
+{
+    forEachItem([&](ItemType* item) {
+        items.push_back(item);
+    });
+}
 
 #endif // HASH_TABLE_H_
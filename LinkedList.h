@@ -1,15 +1,20 @@
 // Specification file for the LinkedList class
 // It is a single linked list class with a sentinel node
+// The nodes can come from a node pool passed to the functions that
+// create and delete them, e.g. the pool of a hash table; without a
+// pool they are allocated with new.
 
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
 #include "ListNode.h"
+#include "ObjectPool.h"
 
 template<class ItemType>
 class LinkedList
 {
 private:
+    ListNode<ItemType> sentinel;  // the sentinel node, kept inside the list
     ListNode<ItemType> *head;
     int length;
 
@@ -19,27 +24,39 @@ public:
 
     // Linked list operations
     int getLength() const {return length;}
-    void insertNode(ItemType*);
-    bool deleteNode(const ItemType&, ItemType*&);
-    bool searchList(const ItemType&, ItemType*&) const;
+    void insertNode(ItemType*, ObjectPool<ListNode<ItemType> >* pool = NULL);
+    // the target may be an item or any key the items compare with
+    template<class Key> bool deleteNode(const Key&, ItemType*&,
+                                        ObjectPool<ListNode<ItemType> >* pool = NULL);
+    template<class Key> bool searchList(const Key&, ItemType*&) const;
+    // delete all the nodes, the nodes from a pool must be
+    // deleted with their pool before the list is destroyed
+    void clear(ObjectPool<ListNode<ItemType> >* pool = NULL);
     void displayList() const;
 
      // gettter
     const ListNode<ItemType>* getHead() const {return head;}
+
+private:
+    // not copyable, head points into the list
+    LinkedList(const LinkedList&);
+    LinkedList& operator=(const LinkedList&);
 };
 
 //**************************************************
 // Constructor
-// This function allocates and initializes a sentinel node
+// This function initializes the sentinel node
 //      A sentinel (or dummy) node is an extra node added before the first data record.
 //      This convention simplifies and accelerates some list-manipulation algorithms,
 //      by making sure that all links can be safely dereferenced and that every list
 //      (even one that contains no data elements) always has a "first" node.
+//      The sentinel is a member rather than a heap node, so an empty list
+//      (e.g. an empty hash table bucket) costs no allocation.
 //**************************************************
 template<class ItemType>
 LinkedList<ItemType>::LinkedList()
 {
-    head = new ListNode<ItemType>; // head points to the sentinel node
+    head = &sentinel; // head points to the sentinel node
     head->setNext(NULL);
     length = 0;
 }
@@ -50,6 +67,17 @@ LinkedList<ItemType>::LinkedList()
 //**************************************************
 template<class ItemType>
 LinkedList<ItemType>::~LinkedList()
+{
+    clear();
+}
+
+//**************************************************
+// The clear function deletes every node in the list.
+// - input param: the pool of the nodes, NULL if they
+//                were allocated with new
+//**************************************************
+template<class ItemType>
+void LinkedList<ItemType>::clear(ObjectPool<ListNode<ItemType> >* pool)
 {
     ListNode<ItemType>* pCur;     // To traverse the list
     ListNode<ItemType>* pNext;    // To hold the address of the next node
@@ -63,29 +91,40 @@ LinkedList<ItemType>::~LinkedList()
         pNext = pCur->getNext();
 
         // Delete the current node.
-        delete pCur;
+        if (pool) {
+            pool->destroy(pCur);
+        }
+        else {
+            delete pCur;
+        }
 
         // Position pCur at the next node.
         pCur = pNext;
     }
-
-    delete head; // delete the sentinel node
+    head->setNext(NULL);
+    length = 0;
 }
 
 //**************************************************
 // The insertNode function inserts a new node in a
 // sorted linked list
-// - input param: the pointer to the data to be inserted
+// - input params: the pointer to the data to be inserted,
+//                 and the node pool, NULL to use new
 //**************************************************
 template<class ItemType>
-void LinkedList<ItemType>::insertNode(ItemType* dataIn)
+void LinkedList<ItemType>::insertNode(ItemType* dataIn, ObjectPool<ListNode<ItemType> >* pool)
 {
     ListNode<ItemType>* newNode;  // A new node
     ListNode<ItemType>* pCur;     // To traverse the list
     ListNode<ItemType>* pPre;     // The previous node
 
     // Allocate a new node and store num there.
-    newNode = new ListNode<ItemType>(dataIn);
+    if (pool) {
+        newNode = pool->create(dataIn);
+    }
+    else {
+        newNode = new ListNode<ItemType>(dataIn);
+    }
  
     // Initialize pointers
     pPre = head;
@@ -111,10 +150,12 @@ void LinkedList<ItemType>::insertNode(ItemType* dataIn)
 // in a sorted linked list; if found, the node is
 // deleted from the list and from memory, returns true
 // and copies the data in that node to the output parameter
-// - input param: target data
+// - input params: target data, and the node pool, NULL to use delete
 //**************************************************
 template<class ItemType>
-bool LinkedList<ItemType>::deleteNode(const ItemType& target, ItemType*& dataOut)
+template<class Key>
+bool LinkedList<ItemType>::deleteNode(const Key& target, ItemType*& dataOut,
+                                      ObjectPool<ListNode<ItemType> >* pool)
 {
     ListNode<ItemType>* pCur;       // To traverse the list
     ListNode<ItemType>* pPre;       // To point to the previous node
@@ -136,7 +177,12 @@ bool LinkedList<ItemType>::deleteNode(const ItemType& target, ItemType*& dataOut
     {
         dataOut = pCur->getItem();
         pPre->setNext(pCur->getNext());
-        delete pCur;
+        if (pool) {
+            pool->destroy(pCur);
+        }
+        else {
+            delete pCur;
+        }
         deleted = true;
         length--;
     }
@@ -151,7 +197,8 @@ bool LinkedList<ItemType>::deleteNode(const ItemType& target, ItemType*& dataOut
 // - input param: target data
 //**************************************************
 template<class ItemType>
-bool LinkedList<ItemType>::searchList(const ItemType& target, ItemType*& dataOut) const
+template<class Key>
+bool LinkedList<ItemType>::searchList(const Key& target, ItemType*& dataOut) const
 {
     ListNode<ItemType>* pCur;       // To traverse the list
     ListNode<ItemType>* pPre;       // To point to the previous node
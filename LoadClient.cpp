@@ -0,0 +1,245 @@
+// Implementation file for the LoadClient class
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+using namespace std;
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "Utils.h"
+#include "LoadClient.h"
+
+//**************************************************
+// Constructor
+//**************************************************
+LoadClient::LoadClient(const string& socketPath, int numConnections, int depth)
+{
+    this->socketPath = socketPath;
+    this->numConnections = max(1, numConnections);
+    this->depth = max(1, depth);
+    elapsed = 0;
+}
+
+//**************************************************
+// read the commands of a script file
+// Blank lines and lines starting with # are skipped
+// - input param: the script filename
+// - return false if the file cannot be opened or has no command
+//**************************************************
+bool LoadClient::loadScript(const string& filename)
+{
+    ifstream inFile(filename);
+    if (!inFile) {
+        cout << "Error opening the script file: \"" << filename << "\"" << endl;
+        return false;
+    }
+
+    string line;
+    while (getline(inFile, line)) {
+        line = trim(line);
+        if (!line.empty() && line[0] != '#') {
+            commands.push_back(line);
+        }
+    }
+    if (commands.empty()) {
+        cout << "No command in the script file: \"" << filename << "\"" << endl;
+        return false;
+    }
+    return true;
+}
+
+//**************************************************
+// send all the commands and wait for all the responses
+// The commands are dealt to the connections in turn
+// - return false if a connection failed
+//**************************************************
+bool LoadClient::run()
+{
+    workers.assign(numConnections, Worker());
+    for (size_t i = 0; i < commands.size(); i++) {
+        workers[i % numConnections].commands.push_back(&commands[i]);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int i = 0; i < numConnections; i++) {
+        threads.push_back(thread(&LoadClient::runWorker, this, ref(workers[i])));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    bool ok = true;
+    for (size_t i = 0; i < workers.size(); i++) {
+        ok = ok && !workers[i].failed;
+    }
+    return ok;
+}
+
+#ifdef __linux__
+
+//**************************************************
+// send the commands of a worker on its own connection,
+// keeping up to depth requests in flight
+// A response is a header line, "OK command N" followed by
+// N lines or "ERR command message"
+// - input param: the worker
+//**************************************************
+void LoadClient::runWorker(Worker& worker)
+{
+    worker.errors = 0;
+    worker.failed = false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        cout << "Error connecting to \"" << socketPath << "\": " << strerror(errno) << endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        worker.failed = true;
+        return;
+    }
+
+    typedef chrono::steady_clock::time_point TimePoint;
+    deque<TimePoint> sent;          // send times of the requests in flight
+    size_t next = 0;                // next command to send
+    size_t total = worker.commands.size();
+    string request;
+    string in;                      // bytes received, not yet parsed
+    size_t pos = 0;                 // start of the unparsed bytes
+    long long linesLeft = -1;       // lines left in the current response, -1 for a header
+    char buf[64 * 1024];
+
+    worker.latencies.reserve(total);
+    while (worker.latencies.size() < total) {
+        // fill the pipeline and send the new requests in one write
+        request.clear();
+        TimePoint now = chrono::steady_clock::now();
+        while (sent.size() < static_cast<size_t>(depth) && next < total) {
+            request += *worker.commands[next++];
+            request += '\n';
+            sent.push_back(now);
+        }
+        if (!request.empty()) {
+            size_t done = 0;
+            while (done < request.size()) {
+                ssize_t n = write(fd, request.data() + done, request.size() - done);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    worker.failed = true;
+                    close(fd);
+                    return;
+                }
+                done += n;
+            }
+        }
+
+        // read and parse the responses
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            cout << "Connection closed by the server" << endl;
+            worker.failed = true;
+            close(fd);
+            return;
+        }
+        in.append(buf, n);
+
+        size_t end;
+        while ((end = in.find('\n', pos)) != string::npos) {
+            if (linesLeft < 0) {
+                // a header line
+                if (in.compare(pos, 3, "OK ") == 0) {
+                    size_t sp = in.rfind(' ', end);
+                    linesLeft = atoll(in.c_str() + sp + 1);
+                }
+                else {
+                    worker.errors++;
+                    linesLeft = 0;
+                }
+            }
+            else {
+                linesLeft--;
+            }
+            pos = end + 1;
+
+            if (linesLeft == 0) {
+                // the whole response is read
+                now = chrono::steady_clock::now();
+                worker.latencies.push_back(
+                    chrono::duration<double, micro>(now - sent.front()).count());
+                sent.pop_front();
+                linesLeft = -1;
+            }
+        }
+        in.erase(0, pos);
+        pos = 0;
+    }
+    close(fd);
+}
+
+#else
+
+//**************************************************
+// the client needs Unix domain sockets
+//**************************************************
+void LoadClient::runWorker(Worker& worker)
+{
+    cout << "The client mode is only available on Linux" << endl;
+    worker.errors = 0;
+    worker.failed = true;
+}
+
+#endif // __linux__
+
+//**************************************************
+// report the QPS and the latency percentiles
+// - input param: the stream to report to
+//**************************************************
+void LoadClient::showStats(ostream& os) const
+{
+    vector<double> latencies;
+    int errors = 0;
+    for (size_t i = 0; i < workers.size(); i++) {
+        latencies.insert(latencies.end(), workers[i].latencies.begin(), workers[i].latencies.end());
+        errors += workers[i].errors;
+    }
+    size_t n = latencies.size();
+    if (n == 0) {
+        os << "No response" << endl;
+        return;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    os << fixed << setprecision(2);
+    os << n << " requests on " << numConnections << " connections, depth " << depth
+       << ", " << errors << " errors, in " << elapsed << " s" << endl;
+    os << "  QPS " << (elapsed > 0 ? n / elapsed : 0) << endl;
+    os << "  latency us: p50 " << latencies[n / 2]
+       << ", p99 " << latencies[(n * 99 + 99) / 100 - 1]
+       << ", p99.9 " << latencies[(n * 999 + 999) / 1000 - 1]
+       << ", max " << latencies[n - 1] << endl;
+}
@@ -0,0 +1,60 @@
+// Specification file for the LoadClient class
+// LoadClient is a load generator for StockServer,
+//   stockdb --client /tmp/stockdb.sock ops.txt [connections] [depth]
+// It reads the commands of a script (see BatchRunner), opens the given
+// number of connections on their own threads, and sends each
+// connection its share of the commands, keeping up to depth requests
+// in flight on it (pipelining). The time from sending a request to
+// reading its whole response is its latency, and the queries per
+// second and the latency percentiles over all the requests are reported.
+
+#ifndef LOAD_CLIENT_H_
+#define LOAD_CLIENT_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+using std::string;
+using std::vector;
+using std::ostream;
+
+class LoadClient
+{
+private:
+    // the requests and results of one connection
+    struct Worker
+    {
+        vector<const string*> commands;   // the commands to send
+        vector<double> latencies;         // microseconds, one per response
+        int errors;                       // ERR responses
+        bool failed;                      // the connection failed
+    };
+
+    string socketPath;
+    int numConnections;
+    int depth;
+    vector<string> commands;
+    vector<Worker> workers;
+    double elapsed;
+
+public:
+    // constructor
+    LoadClient(const string& socketPath, int numConnections, int depth);
+
+    // read the commands of a script file
+    // return false if the file cannot be opened or has no command
+    bool loadScript(const string& filename);
+
+    // send all the commands and wait for all the responses
+    // return false if a connection failed
+    bool run();
+
+    // report the QPS and the latency percentiles to os
+    void showStats(ostream& os) const;
+
+private:
+    // send the commands of a worker on its own connection
+    void runWorker(Worker& worker);
+};
+
+#endif // LOAD_CLIENT_H_
@@ -0,0 +1,96 @@
+// Implementation file for the MappedFile class
+
+#include <fstream>
+#include <string>
+using namespace std;
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+//**************************************************
+// map the file read-only into memory
+// - input param: the name of the file to map
+// - return true if successful, otherwise, false
+//   an empty file is opened successfully with size 0
+//**************************************************
+bool MappedFile::open(const string& filename)
+{
+    // release the previous file if any
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size = st.st_size;
+    if (size > 0) {
+        void* addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            size = 0;
+            return false;
+        }
+        // the file is read front to back once
+        madvise(addr, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(addr);
+        mapped = true;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return true;
+#else
+    // no mmap, read the whole file into a buffer in one go
+    ifstream inFile(filename, ios::binary | ios::ate);
+    if (inFile.fail()) {
+        return false;
+    }
+
+    size = static_cast<size_t>(inFile.tellg());
+    if (size > 0) {
+        char* buf = new char[size];
+        inFile.seekg(0);
+        if (!inFile.read(buf, size)) {
+            delete[] buf;
+            size = 0;
+            return false;
+        }
+        data = buf;
+    }
+    inFile.close();
+    return true;
+#endif
+}
+
+//**************************************************
+// unmap the file and release the buffer
+//**************************************************
+void MappedFile::close()
+{
+    if (data) {
+#ifndef _WIN32
+        if (mapped) {
+            munmap(const_cast<char*>(data), size);
+        }
+#else
+        delete[] data;
+#endif
+    }
+    data = NULL;
+    size = 0;
+    mapped = false;
+}
@@ -0,0 +1,41 @@
+// Specification file for the MappedFile class
+// MappedFile maps a whole file read-only into memory so that
+// it can be parsed in place without copying it through iostreams.
+// On platforms without mmap, the file is read into a buffer instead.
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <string>
+#include <cstddef>
+using std::string;
+
+class MappedFile
+{
+private:
+    const char* data;   // start of the file contents
+    size_t size;        // size of the file in bytes
+    bool mapped;        // true if data is a memory mapping
+
+public:
+    // constructor and destructor
+    MappedFile() {data = NULL; size = 0; mapped = false;}
+    ~MappedFile() {close();}
+
+    // map the file read-only, return true if successful
+    bool open(const string& filename);
+
+    // unmap the file and release the buffer
+    void close();
+
+    // getters
+    const char* getData() const {return data;}
+    size_t getSize() const {return size;}
+
+private:
+    // not copyable
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+#endif // MAPPED_FILE_H_
@@ -0,0 +1,223 @@
+// Specification file for the ObjectPool class
+// ObjectPool is a typed slab allocator: it creates objects of one type
+// in large slabs instead of with one heap allocation per object.
+// A destroyed object goes on a free list and its slot is reused by the
+// next create. release() frees all the slabs at once, so a structure
+// whose objects come from a pool is freed without a heap call per object.
+// destroy also deletes objects that did not come from the pool, so the
+// pool can replace delete for objects created either way.
+// A pool is not thread safe: each thread fills its own pool, and the
+// pools are merged afterwards.
+
+#ifndef OBJECT_POOL_H_
+#define OBJECT_POOL_H_
+
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <algorithm>
+using std::vector;
+
+template<class T>
+class ObjectPool
+{
+private:
+    // a slot holds an object, or the next free slot
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    // a slab of slots
+    struct Slab
+    {
+        Slot* first;
+        int size;
+
+        // slabs are ordered by address
+        bool operator < (const Slab& obj) const {return first < obj.first;}
+    };
+
+    static const int SLAB_SIZE = 4096;   // slots in a slab
+
+    vector<Slab> slabs;   // all the slabs, sorted by address
+    Slot* freeList;       // destroyed slots
+    Slot* nextSlot;       // the unused slots of the last slab
+    Slot* endSlot;
+    int count;            // number of live objects
+
+public:
+    // constructor and destructor
+    ObjectPool() {freeList = NULL; nextSlot = NULL; endSlot = NULL; count = 0;}
+    ~ObjectPool() {release();}
+
+    // getters
+    int getCount() const {return count;}
+    long long getCapacity() const {return static_cast<long long>(slabs.size()) * SLAB_SIZE;}
+    long long getBytes() const {return getCapacity() * sizeof(Slot);}
+
+    // create an object in the pool from the constructor arguments
+    template<class... Args>
+    T* create(Args&&... args);
+
+    // destroy an object and reuse its slot,
+    // or delete it if it is not from the pool
+    void destroy(T* obj);
+
+    // check if an object is in one of the slabs of the pool
+    bool owns(const T* obj) const;
+
+    // free all the slabs at once, without destroying the objects
+    // left in them: destroy them first if they own any memory
+    void release();
+
+    // move all the slabs and free slots of another pool to this one
+    void merge(ObjectPool& other);
+
+private:
+    // allocate a new slab for the next slots
+    void addSlab();
+
+    // not copyable
+    ObjectPool(const ObjectPool&);
+    ObjectPool& operator=(const ObjectPool&);
+};
+
+//**************************************************
+// create an object in the pool
+// The object takes a free slot if there is one,
+// otherwise the next unused slot of the last slab
+// - input params: the arguments of the constructor
+// - return the new object
+//**************************************************
+template<class T>
+template<class... Args>
+T* ObjectPool<T>::create(Args&&... args)
+{
+    Slot* slot = freeList;
+    if (slot) {
+        freeList = slot->next;
+    }
+    else {
+        if (nextSlot == endSlot) {
+            addSlab();
+        }
+        slot = nextSlot++;
+    }
+
+    T* obj = new (slot->data) T(std::forward<Args>(args)...);
+    count++;
+    return obj;
+}
+
+//**************************************************
+// destroy an object of the pool and put its slot on the free list
+// An object that is not from the pool is deleted
+// - input param: the object
+//**************************************************
+template<class T>
+void ObjectPool<T>::destroy(T* obj)
+{
+    if (!obj) {
+        return;
+    }
+    if (!owns(obj)) {
+        delete obj;
+        return;
+    }
+
+    obj->~T();
+    Slot* slot = reinterpret_cast<Slot*>(obj);
+    slot->next = freeList;
+    freeList = slot;
+    count--;
+}
+
+//**************************************************
+// check if an object is in one of the slabs of the pool
+// The slabs are sorted, so it is a binary search
+// - input param: the object
+//**************************************************
+template<class T>
+bool ObjectPool<T>::owns(const T* obj) const
+{
+    const Slot* slot = reinterpret_cast<const Slot*>(obj);
+    Slab key = {const_cast<Slot*>(slot), 0};
+    typename vector<Slab>::const_iterator it = std::upper_bound(slabs.begin(), slabs.end(), key);
+    if (it == slabs.begin()) {
+        return false;
+    }
+    --it;
+    return slot < it->first + it->size;
+}
+
+//**************************************************
+// free all the slabs
+//**************************************************
+template<class T>
+void ObjectPool<T>::release()
+{
+    for (size_t i = 0; i < slabs.size(); i++) {
+        ::operator delete(slabs[i].first);
+    }
+    slabs.clear();
+    freeList = NULL;
+    nextSlot = NULL;
+    endSlot = NULL;
+    count = 0;
+}
+
+//**************************************************
+// move all the slabs of another pool to this one
+// The objects stay where they are, and the unused slots
+// of the other pool become free slots of this one
+// - input param: the other pool, which is left empty
+//**************************************************
+template<class T>
+void ObjectPool<T>::merge(ObjectPool& other)
+{
+    if (&other == this) {
+        return;
+    }
+
+    for (Slot* slot = other.nextSlot; slot != other.endSlot; slot++) {
+        slot->next = freeList;
+        freeList = slot;
+    }
+    while (other.freeList) {
+        Slot* slot = other.freeList;
+        other.freeList = slot->next;
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    size_t n = slabs.size();
+    slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+    std::inplace_merge(slabs.begin(), slabs.begin() + n, slabs.end());
+    count += other.count;
+
+    other.slabs.clear();
+    other.nextSlot = NULL;
+    other.endSlot = NULL;
+    other.count = 0;
+}
+
+//**************************************************
+// allocate a new slab for the next slots,
+// the slabs are kept in address order
+//**************************************************
+template<class T>
+void ObjectPool<T>::addSlab()
+{
+    Slab slab;
+    slab.first = static_cast<Slot*>(::operator new(SLAB_SIZE * sizeof(Slot)));
+    slab.size = SLAB_SIZE;
+    slabs.insert(std::upper_bound(slabs.begin(), slabs.end(), slab), slab);
+
+    nextSlot = slab.first;
+    endSlot = slab.first + SLAB_SIZE;
+}
+
+#endif // OBJECT_POOL_H_
@@ -0,0 +1,473 @@
+// Implementation file for the Screener class
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <bitset>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+using namespace std;
+
+#include "StockColumns.h"
+#include "Screener.h"
+
+// the vector kernels are built with per-function target attributes
+// and chosen at run time, so the program runs on any x86 CPU
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SCREENER_X86 1
+#include <immintrin.h>
+#endif
+
+// a compare kernel: AND the bitmap with (a[i] op value) or
+// (a[i] op value * b[i]) for the n rows, 64 rows per word
+typedef void (*KernelFunc)(const double* a, const double* b, double value, int n, uint64_t* bits);
+
+//**************************************************
+// compare two values
+//**************************************************
+template<int OP>
+static inline bool compareScalar(double x, double y)
+{
+    switch (OP) {
+    case Screener::GT: return x > y;
+    case Screener::GE: return x >= y;
+    case Screener::LT: return x < y;
+    default:           return x <= y;
+    }
+}
+
+//**************************************************
+// the mask of rows first to last - 1 (at most 64 rows)
+// that meet a condition, one row at a time
+//**************************************************
+template<int OP>
+static inline uint64_t scalarWord(const double* a, const double* b, double value,
+                                  int first, int last)
+{
+    uint64_t mask = 0;
+    for (int i = first; i < last; i++) {
+        double y = b ? value * b[i] : value;
+        mask |= static_cast<uint64_t>(compareScalar<OP>(a[i], y)) << (i - first);
+    }
+    return mask;
+}
+
+//**************************************************
+// scalar kernel
+//**************************************************
+template<int OP>
+static void screenScalar(const double* a, const double* b, double value, int n, uint64_t* bits)
+{
+    int numWords = (n + 63) / 64;
+    for (int w = 0; w < numWords; w++) {
+        int first = w * 64;
+        int last = first + 64 < n ? first + 64 : n;
+        bits[w] &= scalarWord<OP>(a, b, value, first, last);
+    }
+}
+
+#ifdef SCREENER_X86
+
+//**************************************************
+// SSE2 kernel, 2 rows per compare
+//**************************************************
+template<int OP>
+__attribute__((target("sse2")))
+static inline __m128d compareSSE2(__m128d x, __m128d y)
+{
+    switch (OP) {
+    case Screener::GT: return _mm_cmpgt_pd(x, y);
+    case Screener::GE: return _mm_cmpge_pd(x, y);
+    case Screener::LT: return _mm_cmplt_pd(x, y);
+    default:           return _mm_cmple_pd(x, y);
+    }
+}
+
+template<int OP>
+__attribute__((target("sse2")))
+static void screenSSE2(const double* a, const double* b, double value, int n, uint64_t* bits)
+{
+    int full = n / 64;
+    __m128d v = _mm_set1_pd(value);
+    for (int w = 0; w < full; w++) {
+        const double* pa = a + w * 64;
+        uint64_t mask = 0;
+        if (b) {
+            const double* pb = b + w * 64;
+            for (int j = 0; j < 64; j += 2) {
+                __m128d y = _mm_mul_pd(v, _mm_loadu_pd(pb + j));
+                __m128d r = compareSSE2<OP>(_mm_loadu_pd(pa + j), y);
+                mask |= static_cast<uint64_t>(_mm_movemask_pd(r)) << j;
+            }
+        }
+        else {
+            for (int j = 0; j < 64; j += 2) {
+                __m128d r = compareSSE2<OP>(_mm_loadu_pd(pa + j), v);
+                mask |= static_cast<uint64_t>(_mm_movemask_pd(r)) << j;
+            }
+        }
+        bits[w] &= mask;
+    }
+    if (full * 64 < n) {
+        bits[full] &= scalarWord<OP>(a, b, value, full * 64, n);
+    }
+}
+
+//**************************************************
+// AVX2 kernel, 4 rows per compare
+//**************************************************
+template<int OP>
+__attribute__((target("avx2")))
+static inline __m256d compareAVX2(__m256d x, __m256d y)
+{
+    switch (OP) {
+    case Screener::GT: return _mm256_cmp_pd(x, y, _CMP_GT_OQ);
+    case Screener::GE: return _mm256_cmp_pd(x, y, _CMP_GE_OQ);
+    case Screener::LT: return _mm256_cmp_pd(x, y, _CMP_LT_OQ);
+    default:           return _mm256_cmp_pd(x, y, _CMP_LE_OQ);
+    }
+}
+
+template<int OP>
+__attribute__((target("avx2")))
+static void screenAVX2(const double* a, const double* b, double value, int n, uint64_t* bits)
+{
+    int full = n / 64;
+    __m256d v = _mm256_set1_pd(value);
+    for (int w = 0; w < full; w++) {
+        const double* pa = a + w * 64;
+        uint64_t mask = 0;
+        if (b) {
+            const double* pb = b + w * 64;
+            for (int j = 0; j < 64; j += 4) {
+                __m256d y = _mm256_mul_pd(v, _mm256_loadu_pd(pb + j));
+                __m256d r = compareAVX2<OP>(_mm256_loadu_pd(pa + j), y);
+                mask |= static_cast<uint64_t>(_mm256_movemask_pd(r)) << j;
+            }
+        }
+        else {
+            for (int j = 0; j < 64; j += 4) {
+                __m256d r = compareAVX2<OP>(_mm256_loadu_pd(pa + j), v);
+                mask |= static_cast<uint64_t>(_mm256_movemask_pd(r)) << j;
+            }
+        }
+        bits[w] &= mask;
+    }
+    if (full * 64 < n) {
+        bits[full] &= scalarWord<OP>(a, b, value, full * 64, n);
+    }
+}
+
+//**************************************************
+// the bitmap of the live rows, 16 rows per compare
+//**************************************************
+__attribute__((target("sse2")))
+static void liveSSE2(const unsigned char* live, int n, uint64_t* bits)
+{
+    int full = n / 64;
+    __m128i zero = _mm_setzero_si128();
+    for (int w = 0; w < full; w++) {
+        const unsigned char* p = live + w * 64;
+        uint64_t mask = 0;
+        for (int j = 0; j < 64; j += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j));
+            __m128i dead = _mm_cmpeq_epi8(x, zero);
+            mask |= static_cast<uint64_t>(~_mm_movemask_epi8(dead) & 0xffff) << j;
+        }
+        bits[w] = mask;
+    }
+    for (int row = full * 64; row < n; row++) {
+        bits[row >> 6] |= static_cast<uint64_t>(live[row] != 0) << (row & 63);
+    }
+}
+
+#endif // SCREENER_X86
+
+//**************************************************
+// the kernel function of a kernel and a comparison
+//**************************************************
+template<int OP>
+static KernelFunc getKernelFunc(Screener::Kernel k)
+{
+#ifdef SCREENER_X86
+    if (k == Screener::AVX2) {
+        return screenAVX2<OP>;
+    }
+    if (k == Screener::SSE2) {
+        return screenSSE2<OP>;
+    }
+#endif
+    return screenScalar<OP>;
+}
+
+static KernelFunc getKernelFunc(Screener::Kernel k, Screener::Op op)
+{
+    switch (op) {
+    case Screener::GT: return getKernelFunc<Screener::GT>(k);
+    case Screener::GE: return getKernelFunc<Screener::GE>(k);
+    case Screener::LT: return getKernelFunc<Screener::LT>(k);
+    default:           return getKernelFunc<Screener::LE>(k);
+    }
+}
+
+//**************************************************
+// the index of the lowest set bit of a nonzero word
+//**************************************************
+static inline int lowestBit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int i = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+//**************************************************
+// Constructor
+//**************************************************
+Screener::Screener()
+{
+    kernel = SCALAR;
+    setKernel(BEST);
+}
+
+//**************************************************
+// check if the CPU supports a kernel
+//**************************************************
+bool Screener::isSupported(Kernel k)
+{
+    switch (k) {
+    case SCALAR:
+    case BEST:
+        return true;
+#ifdef SCREENER_X86
+    case SSE2:
+        return __builtin_cpu_supports("sse2");
+    case AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+//**************************************************
+// the name of a kernel
+//**************************************************
+const char* Screener::getKernelName(Kernel k)
+{
+    static const char* names[] = {"scalar", "SSE2", "AVX2", "best"};
+    return names[k];
+}
+
+//**************************************************
+// select a kernel
+// - input param: the kernel, BEST for the fastest supported one
+// - return false if the CPU does not support it
+//**************************************************
+bool Screener::setKernel(Kernel k)
+{
+    if (k == BEST) {
+        kernel = isSupported(AVX2) ? AVX2 : isSupported(SSE2) ? SSE2 : SCALAR;
+        return true;
+    }
+    if (!isSupported(k)) {
+        return false;
+    }
+    kernel = k;
+    return true;
+}
+
+//**************************************************
+// add a condition: field op value
+//**************************************************
+void Screener::addCondition(StockColumns::Field field, Op op, double value)
+{
+    addCondition(field, op, value, StockColumns::NUM_FIELDS);
+}
+
+//**************************************************
+// add a condition: field op value * other
+//**************************************************
+void Screener::addCondition(StockColumns::Field field, Op op, double value,
+                            StockColumns::Field other)
+{
+    Condition c;
+    c.field = field;
+    c.op = op;
+    c.value = value;
+    c.other = other;
+    conditions.push_back(c);
+}
+
+//**************************************************
+// the field of a name (case insensitive)
+// - return NUM_FIELDS if there is no field with the name
+//**************************************************
+StockColumns::Field Screener::findField(const string& name)
+{
+    static const char* names[StockColumns::NUM_FIELDS] = {
+        "price", "high", "low", "change", "volume", "yearhigh", "yearlow"
+    };
+    string lower(name);
+    for (size_t i = 0; i < lower.size(); i++) {
+        lower[i] = static_cast<char>(tolower(static_cast<unsigned char>(lower[i])));
+    }
+    for (int f = 0; f < StockColumns::NUM_FIELDS; f++) {
+        if (lower == names[f]) {
+            return static_cast<StockColumns::Field>(f);
+        }
+    }
+    return StockColumns::NUM_FIELDS;
+}
+
+//**************************************************
+// parse conditions separated by spaces
+// Each condition is: field op number [field]
+// A field after the number is the other field of the condition,
+// unless an operator follows it, then it starts the next condition
+// - input param: the text of the conditions
+// - return true if successful, otherwise, false and the
+//   reason via output parameter; the conditions are added
+//   only if they are all valid
+//**************************************************
+bool Screener::parse(const string& text, string& error)
+{
+    static const char* ops[] = {">", ">=", "<", "<="};
+
+    vector<string> tokens;
+    istringstream in(text);
+    string token;
+    while (in >> token) {
+        tokens.push_back(token);
+    }
+    if (tokens.empty()) {
+        error = "no condition";
+        return false;
+    }
+
+    vector<Condition> parsed;
+    size_t i = 0;
+    while (i < tokens.size()) {
+        Condition c;
+        c.field = findField(tokens[i]);
+        if (c.field == StockColumns::NUM_FIELDS) {
+            error = "unknown field " + tokens[i];
+            return false;
+        }
+        if (i + 2 >= tokens.size()) {
+            error = "incomplete condition on " + tokens[i];
+            return false;
+        }
+
+        int op = -1;
+        for (int k = 0; k < 4; k++) {
+            if (tokens[i + 1] == ops[k]) {
+                op = k;
+            }
+        }
+        if (op < 0) {
+            error = "unknown operator " + tokens[i + 1];
+            return false;
+        }
+        c.op = static_cast<Op>(op);
+
+        char* end;
+        c.value = strtod(tokens[i + 2].c_str(), &end);
+        if (*end != '\0') {
+            error = "invalid number " + tokens[i + 2];
+            return false;
+        }
+        i += 3;
+
+        // an optional other field
+        c.other = StockColumns::NUM_FIELDS;
+        if (i < tokens.size() && findField(tokens[i]) != StockColumns::NUM_FIELDS) {
+            bool nextIsOp = false;
+            for (int k = 0; k < 4 && i + 1 < tokens.size(); k++) {
+                if (tokens[i + 1] == ops[k]) {
+                    nextIsOp = true;
+                }
+            }
+            if (!nextIsOp) {
+                c.other = findField(tokens[i]);
+                i++;
+            }
+        }
+        parsed.push_back(c);
+    }
+
+    conditions.insert(conditions.end(), parsed.begin(), parsed.end());
+    return true;
+}
+
+//**************************************************
+// the selection bitmap of the rows that meet all the conditions
+// The bitmap starts as the live rows, and each condition
+// is a kernel pass that ANDs its compares into it
+// - input params: the column store, and the bitmap to fill
+// - return the number of rows selected
+//**************************************************
+int Screener::select(const StockColumns& columns, vector<uint64_t>& bits) const
+{
+    int n = columns.getNumRows();
+    int numWords = (n + 63) / 64;
+    bits.assign(numWords, 0);
+
+    const unsigned char* live = columns.getLive();
+#ifdef SCREENER_X86
+    if (kernel != SCALAR) {
+        liveSSE2(live, n, bits.data());
+    }
+    else
+#endif
+    {
+        for (int row = 0; row < n; row++) {
+            bits[row >> 6] |= static_cast<uint64_t>(live[row] != 0) << (row & 63);
+        }
+    }
+
+    for (size_t i = 0; i < conditions.size(); i++) {
+        const Condition& c = conditions[i];
+        const double* b = NULL;
+        if (c.other != StockColumns::NUM_FIELDS) {
+            b = columns.getColumn(c.other);
+        }
+        KernelFunc func = getKernelFunc(kernel, c.op);
+        func(columns.getColumn(c.field), b, c.value, n, bits.data());
+    }
+
+    int count = 0;
+    for (int w = 0; w < numWords; w++) {
+        count += static_cast<int>(bitset<64>(bits[w]).count());
+    }
+    return count;
+}
+
+//**************************************************
+// the rows that meet all the conditions
+// - input params: the column store, and the vector of rows to fill
+// - return the number of rows selected
+//**************************************************
+int Screener::select(const StockColumns& columns, vector<int>& rows) const
+{
+    vector<uint64_t> bits;
+    int count = select(columns, bits);
+
+    rows.clear();
+    rows.reserve(count);
+    for (size_t w = 0; w < bits.size(); w++) {
+        uint64_t word = bits[w];
+        while (word) {
+            rows.push_back(static_cast<int>(w * 64) + lowestBit(word));
+            word &= word - 1;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,90 @@
+// Specification file for the Screener class
+// A Screener selects the stocks whose numeric fields meet a list of
+// conditions, e.g. "change > 2 volume > 5000000 price >= 0.95 yearhigh".
+// A condition compares a field with a constant, or with a multiple of
+// another field of the same stock. The screen runs over the columns of
+// a StockColumns store: each condition is one pass over one or two
+// columns that produces 64 rows of the selection bitmap at a time,
+// with AVX2 or SSE2 compares when the CPU has them and a scalar loop
+// otherwise. The selection is a bitmap of rows, or the list of rows
+// set in it, which StockColumns::getStock turns into stocks.
+
+#ifndef SCREENER_H_
+#define SCREENER_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "StockColumns.h"
+using std::string;
+using std::vector;
+
+class Screener
+{
+public:
+    // the comparison of a condition
+    enum Op {GT, GE, LT, LE};
+
+    // the compare kernels, BEST is the fastest one the CPU supports
+    enum Kernel {SCALAR, SSE2, AVX2, BEST};
+
+    // field op value, or field op value * other when other is a field
+    struct Condition
+    {
+        StockColumns::Field field;
+        Op op;
+        double value;
+        StockColumns::Field other;   // NUM_FIELDS to compare with value
+    };
+
+private:
+    vector<Condition> conditions;
+    Kernel kernel;
+
+public:
+    // constructor, uses the best kernel
+    Screener();
+
+    // getters
+    int getNumConditions() const {return static_cast<int>(conditions.size());}
+    const Condition& getCondition(int i) const {return conditions[i];}
+    Kernel getKernel() const {return kernel;}
+
+    // select a kernel, return false if the CPU does not support it
+    bool setKernel(Kernel k);
+
+    // check if the CPU supports a kernel, and the name of a kernel
+    static bool isSupported(Kernel k);
+    static const char* getKernelName(Kernel k);
+
+    // add a condition: field op value
+    void addCondition(StockColumns::Field field, Op op, double value);
+
+    // add a condition: field op value * other
+    void addCondition(StockColumns::Field field, Op op, double value,
+                      StockColumns::Field other);
+
+    // remove all the conditions
+    void clear() {conditions.clear();}
+
+    // parse conditions separated by spaces, e.g.
+    //   change > 2 volume > 5000000 price >= 0.95 yearhigh
+    // the fields are price, high, low, change, volume, yearhigh
+    // and yearlow; return false and the reason if the text is invalid
+    bool parse(const string& text, string& error);
+
+    // the selection bitmap of the live rows that meet all the
+    // conditions, bit i of word i / 64 is row i
+    // return the number of rows selected
+    int select(const StockColumns& columns, vector<uint64_t>& bits) const;
+
+    // the rows that meet all the conditions, in row order
+    // return the number of rows selected
+    int select(const StockColumns& columns, vector<int>& rows) const;
+
+private:
+    // the field of a name, NUM_FIELDS if there is none
+    static StockColumns::Field findField(const string& name);
+};
+
+#endif // SCREENER_H_
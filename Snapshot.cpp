@@ -0,0 +1,191 @@
+// Implementation file for the binary snapshot functions
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+#include "Stock.h"
+#include "ObjectPool.h"
+#include "Snapshot.h"
+#include "Utils.h"
+
+// magic number at the start of a snapshot file
+static const char SNAPSHOT_MAGIC[8] = {'S', 'T', 'O', 'C', 'K', 'S', 'D', 'B'};
+
+//**************************************************
+// add a string to the string pool, once
+// - input params: the string, the pool, and the offsets
+//                 of the strings already in the pool
+// - return the offset of the string in the pool
+//**************************************************
+static uint32_t addString(const string& s, string& pool,
+                          unordered_map<string, uint32_t>& offsets)
+{
+    unordered_map<string, uint32_t>::iterator it = offsets.find(s);
+    if (it != offsets.end()) {
+        return it->second;
+    }
+    uint32_t off = static_cast<uint32_t>(pool.size());
+    pool.append(s);
+    offsets[s] = off;
+    return off;
+}
+
+//**************************************************
+// check if a file in memory starts with a snapshot header
+// - input params: the file contents and its size
+//**************************************************
+bool isSnapshot(const char* data, size_t size)
+{
+    return size >= sizeof(SnapshotHeader) &&
+           memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+//**************************************************
+// write the stocks to a snapshot file
+// The snapshot is written to a temporary file first, flushed
+// to the disk and renamed over filename when complete, so a
+// crash while saving leaves the previous snapshot intact
+// - input params: the output filename and the stocks to save
+// - return true if successful, otherwise, false
+//**************************************************
+bool saveSnapshot(const string& filename, const vector<Stock*>& stocks)
+{
+    vector<SnapshotRecord> records(stocks.size());
+    string pool;
+    unordered_map<string, uint32_t> offsets;
+
+    for (size_t i = 0; i < stocks.size(); i++) {
+        const Stock* stk = stocks[i];
+        SnapshotRecord& rec = records[i];
+        memset(&rec, 0, sizeof(rec));
+        rec.symbolOff = addString(stk->getSymbol(), pool, offsets);
+        rec.symbolLen = static_cast<uint32_t>(stk->getSymbol().size());
+        rec.companyOff = addString(stk->getCompanyName(), pool, offsets);
+        rec.companyLen = static_cast<uint32_t>(stk->getCompanyName().size());
+        rec.dateOff = addString(stk->getDate(), pool, offsets);
+        rec.dateLen = static_cast<uint32_t>(stk->getDate().size());
+        rec.volume = stk->getVolume();
+        rec.price = stk->getPrice();
+        rec.high = stk->getHigh();
+        rec.low = stk->getLow();
+        rec.change = stk->getChange();
+        rec.yearHigh = stk->getYearHigh();
+        rec.yearLow = stk->getYearLow();
+    }
+
+    // the offsets into the pool are 32 bits
+    if (pool.size() > UINT32_MAX) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.recordSize = sizeof(SnapshotRecord);
+    header.numRecords = records.size();
+    header.poolSize = pool.size();
+    uint64_t h = checksum(reinterpret_cast<const char*>(records.data()),
+                          records.size() * sizeof(SnapshotRecord), 0);
+    header.checksum = checksum(pool.data(), pool.size(), h);
+
+    // write to a temporary file
+    string tmpFile = filename + ".tmp";
+    ofstream outFile(tmpFile, ios::binary | ios::trunc);
+    if (outFile.fail()) {
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char*>(records.data()),
+                  records.size() * sizeof(SnapshotRecord));
+    outFile.write(pool.data(), pool.size());
+    outFile.close();
+    if (outFile.fail() || !syncFile(tmpFile)) {
+        remove(tmpFile.c_str());
+        return false;
+    }
+
+    // replace the old snapshot
+    if (rename(tmpFile.c_str(), filename.c_str()) != 0) {
+        remove(tmpFile.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//**************************************************
+// create new Stock objects from a snapshot file in memory
+// - input params: the file contents and its size, and the
+//                 pool to create the Stock objects in
+// - return true if successful, otherwise, false
+//   return the new Stock objects via output parameter,
+//   and the reason the snapshot is invalid in error
+//**************************************************
+bool loadSnapshot(const char* data, size_t size, vector<Stock*>& stocks, string& error,
+                  ObjectPool<Stock>& stockPool)
+{
+    if (!isSnapshot(data, size)) {
+        error = "not a snapshot file";
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version != SNAPSHOT_VERSION || header.recordSize != sizeof(SnapshotRecord)) {
+        error = "unsupported snapshot version";
+        return false;
+    }
+
+    // the sizes come from the file, so they are only
+    // subtracted from the file size, which cannot overflow
+    size_t dataSize = size - sizeof(header);
+    if (header.numRecords > dataSize / sizeof(SnapshotRecord)) {
+        error = "truncated snapshot file";
+        return false;
+    }
+    size_t recordsSize = header.numRecords * sizeof(SnapshotRecord);
+    if (header.poolSize != dataSize - recordsSize) {
+        error = "truncated snapshot file";
+        return false;
+    }
+
+    const char* recData = data + sizeof(header);
+    const char* pool = recData + recordsSize;
+    uint64_t h = checksum(recData, recordsSize, 0);
+    if (checksum(pool, header.poolSize, h) != header.checksum) {
+        error = "snapshot checksum mismatch";
+        return false;
+    }
+
+    size_t first = stocks.size();
+    stocks.reserve(first + header.numRecords);
+    for (uint64_t i = 0; i < header.numRecords; i++) {
+        SnapshotRecord rec;
+        memcpy(&rec, recData + i * sizeof(SnapshotRecord), sizeof(rec));
+        if (uint64_t(rec.symbolOff) + rec.symbolLen > header.poolSize ||
+            uint64_t(rec.companyOff) + rec.companyLen > header.poolSize ||
+            uint64_t(rec.dateOff) + rec.dateLen > header.poolSize) {
+            error = "bad string offset in snapshot record";
+            // free the Stock objects created so far
+            for (size_t j = first; j < stocks.size(); j++) {
+                stockPool.destroy(stocks[j]);
+            }
+            stocks.resize(first);
+            return false;
+        }
+        Stock* stk = stockPool.create(string(pool + rec.symbolOff, rec.symbolLen),
+                                      string(pool + rec.companyOff, rec.companyLen),
+                                      string(pool + rec.dateOff, rec.dateLen),
+                                      rec.price, rec.high, rec.low, rec.change,
+                                      static_cast<int>(rec.volume), rec.yearHigh, rec.yearLow);
+        stocks.push_back(stk);
+    }
+
+    return true;
+}
@@ -0,0 +1,74 @@
+// Specification file for the binary snapshot functions
+// A snapshot stores all the stocks of the database in a versioned,
+// checksummed binary file that can be loaded without text parsing.
+//
+// File layout (host byte order):
+//   SnapshotHeader
+//   SnapshotRecord[numRecords]  fixed-width numeric records
+//   string pool                 symbols, company names and dates,
+//                               each distinct string stored once
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+using std::string;
+using std::vector;
+
+// Forward Declaration
+class Stock;
+
+template<class T>
+class ObjectPool;
+
+// snapshot file header
+struct SnapshotHeader
+{
+    char magic[8];          // "STOCKSDB"
+    uint32_t version;       // SNAPSHOT_VERSION
+    uint32_t recordSize;    // sizeof(SnapshotRecord)
+    uint64_t numRecords;    // number of records
+    uint64_t poolSize;      // size of the string pool in bytes
+    uint64_t checksum;      // checksum of the records and the string pool
+};
+
+// one stock in the snapshot, strings are offsets into the string pool
+struct SnapshotRecord
+{
+    uint32_t symbolOff;
+    uint32_t companyOff;
+    uint32_t dateOff;
+    uint32_t symbolLen;
+    uint32_t companyLen;
+    uint32_t dateLen;
+    int64_t volume;
+    double price;
+    double high;
+    double low;
+    double change;
+    double yearHigh;
+    double yearLow;
+};
+
+// current snapshot format version
+// version 2 stores the string lengths in 32 bits
+const uint32_t SNAPSHOT_VERSION = 2;
+
+// check if a file in memory starts with a snapshot header
+bool isSnapshot(const char* data, size_t size);
+
+// write the stocks to a snapshot file
+// the file is written to filename.tmp and renamed when complete
+// return false if the string pool does not fit 32-bit offsets
+bool saveSnapshot(const string& filename, const vector<Stock*>& stocks);
+
+// create new Stock objects in stockPool from a snapshot file in memory
+// return false and the reason in error if the snapshot is invalid,
+// no Stock objects are returned in that case
+bool loadSnapshot(const char* data, size_t size, vector<Stock*>& stocks, string& error,
+                  ObjectPool<Stock>& stockPool);
+
+#endif // SNAPSHOT_H_
@@ -1,4 +1,6 @@
 // Specification file for the Stack class
+// The stack nodes are created in an object pool, which
+// reuses the nodes of popped items and frees them all at once
 
 #ifndef STACK_H_
 #define STACK_H_
@@ -6,6 +8,8 @@
 #include <iostream>
 using namespace std;
 
+#include "ObjectPool.h"
+
 template <class ItemType>
 class Stack
 {
@@ -19,6 +23,7 @@ private:
 
     StackNode *top;     // Pointer to the stack top
     int length;
+    ObjectPool<StackNode> nodes;  // the pool of the stack nodes
 
 public:
     // Constructor
@@ -53,9 +58,7 @@ bool Stack<ItemType>::push(ItemType* item)
     StackNode* newNode; // Pointer to a new node
 
     // Allocate a new node and store num there.
-    newNode = new StackNode;
-    if (!newNode)
-        return false;
+    newNode = nodes.create();
     newNode->value = item;
 
     // Update links and counter
@@ -78,28 +81,19 @@ ItemType* Stack<ItemType>::pop()
     // Update the top of the stack to next node
     top = currNode->next;
     length--;
-    delete currNode;
+    nodes.destroy(currNode);
     return item;
 }
 
 //**************************************************
 // Destructor
+// The nodes are freed at once with their pool
 //**************************************************
 template <class ItemType>
 Stack<ItemType>::~Stack()
 {
-    StackNode* currNode;
-
-    // Position nodePtr at the top of the stack.
-    currNode = top;
-
-    // Traverse the list deleting each node.
-    while (currNode)
-    {
-        top = currNode->next;
-        delete currNode;
-        currNode = top;
-    }
+    nodes.release();
+    top = NULL;
 }
 
 #endif
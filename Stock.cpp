@@ -3,9 +3,11 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <climits>
 using namespace std;
 
 #include "Stock.h"
+#include "Utils.h"
 
 //**************************************************
 // Constructor
@@ -22,6 +24,9 @@ Stock::Stock()
     volume = -1;
     year_high = -1;
     year_low = -1;
+    days = INT_MIN;
+    rowId = -1;
+    key = 0;
 }
 
 //**************************************************
@@ -41,6 +46,22 @@ Stock::Stock(string sb, string cp, string dt,
     volume = vo;
     year_high = yh;
     year_low = yl;
+    rowId = -1;
+    packDate();
+}
+
+//**************************************************
+// parse the date into days since 01/01/1970 and
+// pack the symbol and the date into the 64-bit key
+//**************************************************
+void Stock::packDate()
+{
+    if (!parseDate(date, days)) {
+        days = INT_MIN;
+        key = 0;
+        return;
+    }
+    key = packKey(symbol, days);
 }
 
  //***********************************************************
@@ -64,12 +85,39 @@ ostream& operator<<(ostream& os, const Stock& obj) {
     return os;
 }
 
+//***********************************************************
+// compare two unique keys (symbol + date)
+// The keys order by symbol, then chronologically, so 1/5/2021
+// and 01/05/2021 are the same date. Dates that cannot be parsed
+// come first and are ordered by the date strings. Two packed
+// keys are in the same order, so they are compared in one step.
+// - return < 0, 0 or > 0
+//***********************************************************
+static int compareKeys(uint64_t k1, string_view sb1, int days1, string_view dt1,
+                       uint64_t k2, string_view sb2, int days2, string_view dt2)
+{
+    if (k1 && k2) {
+        return (k1 < k2) ? -1 : (k1 > k2 ? 1 : 0);
+    }
+    int c = sb1.compare(sb2);
+    if (c != 0) {
+        return c;
+    }
+    if (days1 != days2) {
+        return (days1 < days2) ? -1 : 1;
+    }
+    if (days1 != INT_MIN) {
+        return 0;
+    }
+    return dt1.compare(dt2);
+}
+
 //***********************************************************
 // overloading operator <
 // It uses the unique key of the Stock object (symbol + date)
 //***********************************************************
 bool Stock::operator < (const Stock& obj) const {
-    return (getUniqueKey() < obj.getUniqueKey());
+    return compareKeys(key, symbol, days, date, obj.key, obj.symbol, obj.days, obj.date) < 0;
 }
 
 //***********************************************************
@@ -77,7 +125,7 @@ bool Stock::operator < (const Stock& obj) const {
 // It uses the unique key of the Stock object (symbol + date)
 //***********************************************************
 bool Stock::operator > (const Stock& obj) const {
-    return (getUniqueKey() > obj.getUniqueKey());
+    return compareKeys(key, symbol, days, date, obj.key, obj.symbol, obj.days, obj.date) > 0;
 }
 
 //***********************************************************
@@ -85,6 +133,49 @@ bool Stock::operator > (const Stock& obj) const {
 // It uses the unique key of the Stock object (symbol + date)
 //***********************************************************
 bool Stock::operator == (const Stock& obj) const {
-    return (getUniqueKey() == obj.getUniqueKey());
+    return compareKeys(key, symbol, days, date, obj.key, obj.symbol, obj.days, obj.date) == 0;
+}
+
+//***********************************************************
+// compare the unique key of the Stock object with a lookup key
+//***********************************************************
+bool Stock::operator < (const StockKey& k) const {
+    return compareKeys(key, symbol, days, date, k.key, k.symbol, k.days, k.date) < 0;
+}
+
+bool Stock::operator > (const StockKey& k) const {
+    return compareKeys(key, symbol, days, date, k.key, k.symbol, k.days, k.date) > 0;
+}
+
+bool Stock::operator == (const StockKey& k) const {
+    return compareKeys(key, symbol, days, date, k.key, k.symbol, k.days, k.date) == 0;
+}
+
+//***********************************************************
+// StockKey constructor: parses the date and packs the key
+// like a Stock object, without copying the strings
+//***********************************************************
+StockKey::StockKey(string_view sb, string_view dt)
+{
+    symbol = sb;
+    date = dt;
+    if (parseDate(date, days)) {
+        key = packKey(symbol, days);
+    }
+    else {
+        days = INT_MIN;
+        key = 0;
+    }
+}
+
+//***********************************************************
+// StockKey constructor: the key of a Stock object
+//***********************************************************
+StockKey::StockKey(const Stock& stk)
+{
+    symbol = stk.getSymbol();
+    date = stk.getDate();
+    days = stk.getDays();
+    key = stk.getKey();
 }
 
@@ -1,16 +1,27 @@
 // Specification file for the Stock class
 // The primary key of the Stock object is symbol + date
 // The secondary key of the Stock object is company name
+// The date is parsed once into days since 01/01/1970, and the symbol
+// and date are packed into a 64-bit key (see packKey in Utils.h), so
+// comparing and hashing stocks does not build strings. Stocks whose
+// symbol or date cannot be packed are compared by symbol and days,
+// in the same order, and by the date string if it cannot be parsed.
+// StockKey is a lightweight symbol + date key for lookups: it refers
+// to the strings it is made from and does not allocate memory.
 
 #ifndef STOCK_H_
 #define STOCK_H_
 
 #include<string>
+#include<string_view>
+#include<cstdint>
 
 using std::string;
+using std::string_view;
 using std::ostream;
 
 class Stock; // Forward Declaration
+struct StockKey;
 
 // Function Prototypes for Overloaded Stream Operators
 ostream& operator << (ostream&, const Stock&);
@@ -28,6 +39,12 @@ private:
     int volume;  
     double year_high;
     double year_low;
+    int days;           // date as days since 01/01/1970, INT_MIN if invalid
+    int rowId;          // row in the column store of the DB, -1 if none
+    uint64_t key;       // packed symbol + date, 0 if they do not fit
+
+    // parse the date and pack the key
+    void packDate();
 
 public:
 
@@ -36,9 +53,9 @@ public:
     Stock(string, string, string, double, double, double, double, int, double, double);
 
     // setters
-    void setSymbol(string sb) { symbol = sb;  }
+    void setSymbol(string sb) { symbol = sb; packDate(); }
     void setCompanyName(string cp) { company = cp;  }
-    void setDate(string dt) { date = dt; }
+    void setDate(string dt) { date = dt; packDate(); }
     void setPrice(double pr) { price = pr; }
     void setHigh(double hi) { high = hi; }
     void setLow(double lo) { low = lo; }
@@ -46,12 +63,13 @@ public:
     void setVolume(int vo) { volume = vo; }
     void setYearHigh(double yh) { year_high = yh; }
     void setYearLow(double yl) { year_low = yl; }
+    void setRowId(int row) { rowId = row; }
     
 
     // getters
-    string getSymbol() const { return symbol; }
-    string getCompanyName() const { return company; }
-    string getDate() const { return date; }
+    const string& getSymbol() const { return symbol; }
+    const string& getCompanyName() const { return company; }
+    const string& getDate() const { return date; }
     double getPrice() const { return price; }
     double getHigh() const { return high; }
     double getLow() const { return low; }
@@ -59,6 +77,9 @@ public:
     double getChange() const { return change; }
     double getYearHigh() const { return year_high; }
     double getYearLow() const { return year_low; }
+    int getDays() const { return days; }
+    int getRowId() const { return rowId; }
+    uint64_t getKey() const { return key; }
 
     // get the unique key of the stock data (symbol + date)
     string getUniqueKey() const { return symbol + date; }
@@ -79,6 +100,31 @@ public:
     
     // overloading the operator ==
     bool operator == (const Stock& obj) const;
+
+    // compare with a lookup key, in the same order as with a Stock
+    bool operator < (const StockKey& key) const;
+    bool operator > (const StockKey& key) const;
+    bool operator == (const StockKey& key) const;
+};
+
+// the primary key (symbol + date) of a stock, for lookups
+// The symbol and date strings must outlive the key
+struct StockKey
+{
+    string_view symbol;
+    string_view date;
+    int days;           // date as days since 01/01/1970, INT_MIN if invalid
+    uint64_t key;       // packed symbol + date, 0 if they do not fit
+
+    // constructors
+    StockKey(string_view sb, string_view dt);
+    StockKey(const Stock& stk);
+
+    // getters, named like the Stock getters
+    string_view getSymbol() const { return symbol; }
+    string_view getDate() const { return date; }
+    int getDays() const { return days; }
+    uint64_t getKey() const { return key; }
 };
 
 #endif // STOCK_H_
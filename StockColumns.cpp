@@ -0,0 +1,176 @@
+// Implementation file for the StockColumns class
+
+#include <vector>
+#include <limits>
+using namespace std;
+
+#include "Stock.h"
+#include "StockColumns.h"
+
+//**************************************************
+// return the name of a field
+//**************************************************
+const char* StockColumns::getFieldName(Field field)
+{
+    static const char* names[NUM_FIELDS] = {
+        "Price", "High", "Low", "Change", "Volume", "Year High", "Year Low"
+    };
+    return names[field];
+}
+
+//**************************************************
+// make room for n rows
+// - input param: the number of rows
+//**************************************************
+void StockColumns::reserve(int n)
+{
+    for (int f = 0; f < NUM_FIELDS; f++) {
+        columns[f].reserve(n);
+    }
+    days.reserve(n);
+    live.reserve(n);
+    stocks.reserve(n);
+}
+
+//**************************************************
+// add a stock in a new row at the end of the columns
+// - input param: the stock, its row ID is set to the new row
+//**************************************************
+void StockColumns::add(Stock* stk)
+{
+    columns[PRICE].push_back(stk->getPrice());
+    columns[HIGH].push_back(stk->getHigh());
+    columns[LOW].push_back(stk->getLow());
+    columns[CHANGE].push_back(stk->getChange());
+    columns[VOLUME].push_back(stk->getVolume());
+    columns[YEAR_HIGH].push_back(stk->getYearHigh());
+    columns[YEAR_LOW].push_back(stk->getYearLow());
+    days.push_back(stk->getDays());
+    live.push_back(1);
+    stocks.push_back(stk);
+
+    stk->setRowId(static_cast<int>(live.size()) - 1);
+    count++;
+}
+
+//**************************************************
+// mark the row of a stock dead
+// The rows are compacted when most of them are dead
+// - input param: the stock, its row ID is cleared
+// - return true if the stock had a row, otherwise, false
+//**************************************************
+bool StockColumns::remove(Stock* stk)
+{
+    int row = stk->getRowId();
+    if (row < 0 || row >= getNumRows() || stocks[row] != stk) {
+        return false;
+    }
+
+    live[row] = 0;
+    stocks[row] = NULL;
+    stk->setRowId(-1);
+    count--;
+
+    int dead = getNumRows() - count;
+    if (dead >= MIN_COMPACT && dead > count) {
+        compact();
+    }
+
+    return true;
+}
+
+//**************************************************
+// remove all the rows, the stocks keep their row IDs
+//**************************************************
+void StockColumns::clear()
+{
+    for (int f = 0; f < NUM_FIELDS; f++) {
+        columns[f].clear();
+    }
+    days.clear();
+    live.clear();
+    stocks.clear();
+    count = 0;
+}
+
+//**************************************************
+// move the live rows down over the dead rows
+//**************************************************
+void StockColumns::compact()
+{
+    int n = getNumRows();
+    int to = 0;
+    for (int row = 0; row < n; row++) {
+        if (!live[row]) {
+            continue;
+        }
+        if (to != row) {
+            for (int f = 0; f < NUM_FIELDS; f++) {
+                columns[f][to] = columns[f][row];
+            }
+            days[to] = days[row];
+            live[to] = 1;
+            stocks[to] = stocks[row];
+            stocks[to]->setRowId(to);
+        }
+        to++;
+    }
+
+    for (int f = 0; f < NUM_FIELDS; f++) {
+        columns[f].resize(to);
+    }
+    days.resize(to);
+    live.resize(to);
+    stocks.resize(to);
+}
+
+//**************************************************
+// the aggregates of a field over all the live rows
+// - input param: the field
+// - return the count, min, max and sum of the field
+//**************************************************
+StockColumns::Summary StockColumns::summarize(Field field) const
+{
+    return summarize(field, numeric_limits<int>::min(), numeric_limits<int>::max());
+}
+
+//**************************************************
+// the aggregates of a field over the live rows in a date range
+// The scan reads the field, date and live columns in order
+// - input params: the field, and the first and last dates
+//                 (days since 01/01/1970, both included)
+// - return the count, min, max and sum of the field
+//**************************************************
+StockColumns::Summary StockColumns::summarize(Field field, int fromDays, int toDays) const
+{
+    Summary s;
+    s.count = 0;
+    s.min = numeric_limits<double>::infinity();
+    s.max = -numeric_limits<double>::infinity();
+    s.sum = 0;
+
+    const double* col = columns[field].data();
+    const int* d = days.data();
+    const unsigned char* alive = live.data();
+    int n = getNumRows();
+    for (int row = 0; row < n; row++) {
+        if (!alive[row] || d[row] < fromDays || d[row] > toDays) {
+            continue;
+        }
+        double v = col[row];
+        s.count++;
+        s.sum += v;
+        if (v < s.min) {
+            s.min = v;
+        }
+        if (v > s.max) {
+            s.max = v;
+        }
+    }
+
+    if (s.count == 0) {
+        s.min = 0;
+        s.max = 0;
+    }
+    return s;
+}
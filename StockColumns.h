@@ -0,0 +1,94 @@
+// Specification file for the StockColumns class
+// StockColumns is the column store of the stock database: the numeric
+// fields of the stocks are copied into one contiguous array per field,
+// indexed by a row ID kept in each Stock object. A scan of a field
+// reads 8 bytes per stock from one array instead of visiting every
+// Stock object, so aggregates over all the stocks run at memory speed.
+// Removing a stock only marks its row dead; the rows are compacted
+// when more than half of them are dead.
+// StockColumns only stores the pointers to the Stock objects
+
+#ifndef STOCK_COLUMNS_H_
+#define STOCK_COLUMNS_H_
+
+#include <vector>
+using std::vector;
+
+class Stock;
+
+class StockColumns
+{
+public:
+    // the numeric fields of a stock, one column each
+    // The volume is stored as a double, so all the columns
+    // are scanned by the same code
+    enum Field {PRICE, HIGH, LOW, CHANGE, VOLUME, YEAR_HIGH, YEAR_LOW, NUM_FIELDS};
+
+    // the aggregates of a column over the live rows
+    struct Summary
+    {
+        int count;
+        double min;
+        double max;
+        double sum;
+
+        double getAverage() const {return count ? sum / count : 0;}
+    };
+
+private:
+    // do not compact fewer dead rows than this
+    static const int MIN_COMPACT = 1024;
+
+    vector<double> columns[NUM_FIELDS];  // the field values of each row
+    vector<int> days;                    // the date of each row, see Stock::getDays
+    vector<unsigned char> live;          // 1 if the row holds a stock, 0 if dead
+    vector<Stock*> stocks;               // the stock of each row, NULL if dead
+    int count;                           // number of live rows
+
+public:
+    // constructor
+    StockColumns() {count = 0;}
+
+    // getters
+    int getNumRows() const {return static_cast<int>(live.size());}
+    int getCount() const {return count;}
+    bool isEmpty() const {return count == 0;}
+
+    // the columns, each getNumRows() long
+    const double* getColumn(Field field) const {return columns[field].data();}
+    const int* getDays() const {return days.data();}
+    const unsigned char* getLive() const {return live.data();}
+    Stock* getStock(int row) const {return stocks[row];}
+
+    // the name of a field
+    static const char* getFieldName(Field field);
+
+    // make room for n rows, e.g. before a bulk load
+    void reserve(int n);
+
+    // add a stock in a new row and set its row ID
+    void add(Stock* stk);
+
+    // mark the row of a stock dead and clear its row ID
+    // return false if the stock has no row
+    bool remove(Stock* stk);
+
+    // remove all the rows
+    void clear();
+
+    // the aggregates of a field over all the stocks,
+    // or the stocks from fromDays to toDays (both included)
+    Summary summarize(Field field) const;
+    Summary summarize(Field field, int fromDays, int toDays) const;
+
+private:
+    // move the live rows down over the dead rows
+    // and update the row IDs of their stocks
+    void compact();
+
+    // not copyable
+    StockColumns(const StockColumns&);
+    StockColumns& operator=(const StockColumns&);
+};
+
+#endif // STOCK_COLUMNS_H_
@@ -6,15 +6,31 @@
 #include <sstream>
 #include <string>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <climits>
+#include <chrono>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 #include "Stock.h"
-#include "BinarySearchTree.h"
-#include "LinkedList.h"
+#include "CompanyIndex.h"
+#include "SymbolIndex.h"
+#include "TopStocks.h"
+#include "StockColumns.h"
+#include "Screener.h"
+#include "ConcurrentIndex.h"
+#include "BackgroundSaver.h"
 #include "HashTable.h"
 #include "Utils.h"
 #include "Stack.h"
+#include "ObjectPool.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "Snapshot.h"
+#include "WriteAheadLog.h"
 #include "StockDB.h"
 
 //**************************************************
@@ -25,6 +41,32 @@ StockDB::StockDB()
     // set to null
     bst = NULL;
     hash = NULL;
+    symbols = NULL;
+    movers = NULL;
+    columns = NULL;
+    shared = NULL;
+    stack = NULL;
+    wal = NULL;
+
+    // the pools live as long as the DB object
+    stockPool = new ObjectPool<Stock>();
+    nodePool = new ObjectPool<ListNode<Stock> >();
+
+    // no save in progress
+    saver = new BackgroundSaver();
+    saveLogSize = 0;
+    saveLogRecords = 0;
+
+    // log every change and fsync each operation
+    walEnabled = true;
+    walSync = 1;
+
+    // show the whole table
+    pageSize = 0;
+
+    // search batches on this thread
+    searchThreads = 1;
+    searchPool = NULL;
 
     // set to default
     dbFile = DEF_DB_FILENAME;
@@ -37,15 +79,33 @@ StockDB::StockDB()
 //**************************************************
 StockDB::~StockDB()
 {
+    // finish a save in progress while the log is still open
+    finishSave(cout);
+
+    // flush and close the write-ahead log
+    if (wal) {
+        delete wal;
+        wal = NULL;
+    }
+
     // free all memory
     freeDB();
+    delete searchPool;
+    delete saver;
+    delete stockPool;
+    delete nodePool;
 }
 
 //**************************************************
 // freeing all memory in the database
+// The stocks and list nodes are returned to their pools,
+// which then free their slabs at once
 //**************************************************
 void StockDB::freeDB()
 {
+    // a background save may still be reading the stocks
+    finishSave(cout);
+
     if (bst) {
         delete bst;
         bst = NULL;
@@ -54,16 +114,38 @@ void StockDB::freeDB()
         delete hash;
         hash = NULL;
     }
+    if (symbols) {
+        delete symbols;
+        symbols = NULL;
+    }
+    if (movers) {
+        delete movers;
+        movers = NULL;
+    }
+    if (columns) {
+        delete columns;
+        columns = NULL;
+    }
+    if (shared) {
+        delete shared;
+        shared = NULL;
+    }
     if (stack) {
         // free deleted books
         while (!stack->isEmpty()) {
             Stock* b = stack->pop();
-            delete b;
+            stockPool->destroy(b);
         }
         // free stack obj
         delete stack;
         stack = NULL;
     }
+
+    // a stock that is being added keeps its pool
+    nodePool->release();
+    if (stockPool->getCount() == 0) {
+        stockPool->release();
+    }
 }
 
 //**************************************************
@@ -77,16 +159,14 @@ bool StockDB::initDB(int hashSize)
     freeDB();
 
     // create BST
-    // pass a compare function
-    bst = new BinarySearchTree<Stock>(compare);
+    bst = new CompanyIndex();
     if (!bst) {
-        cout << "Failed to create BinarySearchTree in StockDB" << endl;
+        cout << "Failed to create CompanyIndex in StockDB" << endl;
         return false;
     }
 
     // create Hash table
-    // pass a hash function
-    hash = new HashTable<Stock>(hashSize, key_to_index);
+    hash = new StockHash(hashSize);
     if (!hash) {
         cout << "Failed to create HashTable in StockDB" << endl;
         // free BST memory if it has been created
@@ -96,6 +176,28 @@ bool StockDB::initDB(int hashSize)
         }
         return false;
     }
+    hash->setPools(stockPool, nodePool);
+
+    // create symbol index
+    symbols = new SymbolIndex();
+    if (!symbols) {
+        cout << "Failed to create SymbolIndex in StockDB" << endl;
+        return false;
+    }
+
+    // create top stocks index
+    movers = new TopStocks();
+    if (!movers) {
+        cout << "Failed to create TopStocks in StockDB" << endl;
+        return false;
+    }
+
+    // create column store
+    columns = new StockColumns();
+    if (!columns) {
+        cout << "Failed to create StockColumns in StockDB" << endl;
+        return false;
+    }
 
     // create Stack
     stack = new Stack<Stock>();
@@ -119,9 +221,15 @@ void StockDB::showMenu() const
     cout << "A - Add a new stock" << endl;
     cout << "D - Delete a stock (by Symbol + Date)" << endl;
     cout << "E - Delete a stock (by Company Name)" << endl;
+    cout << "R - Search a symbol in a date range" << endl;
+    cout << "K - Show the top gainers, losers and volume of a date" << endl;
+    cout << "I - Show the price indicators of a symbol" << endl;
     cout << "F - Save to file" << endl;
+    cout << "V - Show the progress of the save" << endl;
     cout << "G - Undo delete" << endl;
     cout << "O - Show statistics" << endl;
+    cout << "M - Show a summary of the numeric fields" << endl;
+    cout << "C - Screen stocks by their numeric fields" << endl;
     cout << "Q - Quit" << endl;
 }
 
@@ -139,6 +247,10 @@ void StockDB::mainMenu()
         cout << "Please enter an option (h - for help): ";
         cin.clear();
         cin >> str;
+        // report a background save that ended
+        if (saver->isOver()) {
+            finishSave(cout);
+        }
         if (str == "h") {
             // show menu (hidden option)
             showMenu();
@@ -155,7 +267,9 @@ void StockDB::mainMenu()
             }
             else {
                 // save the DB to the default output DB file
-                saveToFile(true);
+                // and wait for it
+                finishSave(cout);
+                saveDB(dbFile, cout);
             }
             // quit the program
             cout << "Exit the program" << endl;
@@ -190,6 +304,18 @@ void StockDB::mainMenu()
                     // search stock by company name
                     searchCompany();
                 }
+                else if (str == "R") {
+                    // search stocks by symbol and date range
+                    searchRange();
+                }
+                else if (str == "K") {
+                    // show the top movers of a date
+                    showTopStocks();
+                }
+                else if (str == "I") {
+                    // show the SMA, EMA, VWAP and Bollinger bands
+                    showIndicators();
+                }
                 else if (str == "D") {
                     // delete a stock by symbol and date
                     deleteSymbol();
@@ -209,6 +335,18 @@ void StockDB::mainMenu()
                     // show DB's statistics
                     showStatistics();
                 }
+                else if (str == "V") {
+                    // show the progress of a background save
+                    showSaveProgress();
+                }
+                else if (str == "M") {
+                    // show min, max and average of each numeric field
+                    showSummary();
+                }
+                else if (str == "C") {
+                    // screen stocks by conditions on their fields
+                    screenStocks();
+                }
                 else {
                     cout << "Invalid menu option. Try again." << endl;
                 }
@@ -220,26 +358,98 @@ void StockDB::mainMenu()
 //**************************************************
 // display sorted data by company name
 // as a table, with header and footer included
+// With a page size, the user pages through the table
+// or jumps to a row
 //**************************************************
 void StockDB::displayDB() const
 {
-    // header of the table
-    cout << left;
-    cout << " " << setw(6) << "Symbol" << " ";
-    cout << " " << setw(22) << "Company Name" << " ";
-    cout << " " << setw(10) << "Date" << " ";
-    cout << fixed << setprecision(2);
-    cout << " " << setw(9) << "Price" << " ";
-    cout << " " << setw(9) << "Day High" << " ";
-    cout << " " << setw(9) << "Day Low" << " ";
-    cout << " " << setw(9) << "Change" << " ";
-    cout << " " << setw(9) << "Volume" << " ";
-    cout << " " << setw(9) << "52wk High" << " ";
-    cout << " " << setw(9) << "52wk Low" << " ";
-    cout << endl;
+    int total = bst->getCount();
+    if (pageSize <= 0) {
+        displayDB(cout, 0, total);
+        cout << flush;
+        return;
+    }
+
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    long long offset = 0;
+    while (true) {
+        int n = displayDB(cout, offset, pageSize);
+        cout << "Rows " << offset + 1 << "-" << offset + n << " of " << total
+             << ". Enter for the next page, a row number to go to, or q to quit: ";
+        string str;
+        if (!getline(cin, str)) {
+            break;
+        }
+        str = trim(str);
+        if (str == "q") {
+            break;
+        }
+        if (str.empty()) {
+            offset += pageSize;
+            if (offset >= total) {
+                break;
+            }
+            continue;
+        }
+        long long row = atoll(str.c_str());
+        if (row < 1 || row > total) {
+            cout << "Invalid row number. Try again." << endl;
+            continue;
+        }
+        offset = row - 1;
+    }
+}
+
+//**************************************************
+// write a window of the table of the stocks sorted by company name
+// The rows are fetched from the company index a chunk at a time,
+// formatted in a buffer and written to the stream in large blocks
+// - input params: the stream to write to, the first row
+//                 (0 for the first stock), and the most rows
+// - return the number of rows written
+//**************************************************
+int StockDB::displayDB(ostream& os, long long offset, int limit) const
+{
+    const int CHUNK = 4096;
+    const size_t BLOCK_SIZE = 1 << 20;
+
+    string block;
+    block.reserve(BLOCK_SIZE + 512);
+    appendTableHeader(block);
+
+    int done = 0;
+    vector<Stock*> rows;
+    while (done < limit) {
+        rows.clear();
+        if (getSortedStocks(offset + done, min(CHUNK, limit - done), rows) == 0) {
+            break;
+        }
+        for (size_t i = 0; i < rows.size(); i++) {
+            appendTableRow(block, *rows[i]);
+            if (block.size() >= BLOCK_SIZE) {
+                os.write(block.data(), block.size());
+                block.clear();
+            }
+        }
+        done += static_cast<int>(rows.size());
+    }
+    os.write(block.data(), block.size());
+    return done;
+}
 
-    // display stocks sorted by company name
-    bst->inOrder(tDisplay);
+//**************************************************
+// get a window of the stocks sorted by company name
+// - input params: the first row (0 for the first stock), the
+//                 most stocks, and the vector to append them to
+// - return the number of stocks appended
+//**************************************************
+int StockDB::getSortedStocks(long long offset, int limit, vector<Stock*>& stocks) const
+{
+    if (!bst) {
+        return 0;
+    }
+    return bst->getRows(offset, limit, stocks);
 }
 
 //**************************************************
@@ -259,265 +469,742 @@ void StockDB::displayHash() const
 }
 
 //**************************************************
-// load database from a file to internal bst and hash table
-//   - input param: filename - database file to load
-//   - return true if successful, otherwise, false
+// parse one line of the DB file into a new Stock object
+//   - input params: the character range [first, last) of the line
+//                   without the newline, the line number,
+//                   the stream to report errors to, and the
+//                   pool to create the Stock object in
+//   - return the new Stock object if successful, otherwise, NULL
 //**************************************************
-bool StockDB::loadDB(const string& filename)
+Stock* StockDB::parseLine(const char* first, const char* last, int lineNo, ostream& os,
+                          ObjectPool<Stock>& pool)
 {
-    // Grabbing input file size size
-    int numLines = 0;
-    string lineCount;
-    ifstream lineCheck(filename);
-    if (lineCheck.fail())
-    {
-        cout << "Error opening the input file: \"" << filename << "\"" << endl;
-        return false;
-    }
+    double price, high, low, change, yearHigh, yearLow;
+    int volume;
 
-    while (getline(lineCheck, lineCount))
-        ++numLines;
-    lineCheck.close();
+    // the fields are: symbol company; date; price high low change volume yearHigh yearLow
+    const char* p = first;
+    const char* q = static_cast<const char*>(memchr(p, ' ', last - p));
+    if (!q) {
+        q = last;
+    }
+    string symbol(p, q);
+    p = (q < last) ? q + 1 : last;
 
-    // return true if the input file is empty
-    if (numLines == 0) {
-        cout << "Input file is empyt: \"" << filename << "\"" << endl;
-        return true;
+    q = static_cast<const char*>(memchr(p, ';', last - p));
+    if (!q) {
+        q = last;
     }
+    string company(p, q);
+    p = (q < last) ? q + 1 : last;
 
-    int hashSize = nextPrime(numLines * 2);
-    string symbol, company, date;
-    double price, high, low, change, yearHigh, yearLow;
-    int volume;
+    // skip the blank after the semicolon
+    if (p < last) {
+        p++;
+    }
+    q = static_cast<const char*>(memchr(p, ';', last - p));
+    if (!q) {
+        q = last;
+    }
+    string date(p, q);
+    p = (q < last) ? q + 1 : last;
 
-    ifstream inFile(filename);
-    if (inFile.fail())
+    // check for negative or non-numeric input data
+    // if there is any error loading the rest of the line,
+    // continue to next line
+    if (!parseNumber(p, last, price) || price < 0)
     {
-        cout << "Error opening the input file: \"" << filename << "\"" << endl;
-        return false;
+        os << "Error inserting price from line " << lineNo << endl;
+        return NULL;
     }
-
-    // create an empty database
-    if (!initDB(hashSize)) {
-        cout << "Failed to create an empty StockDB" << endl;
-        // close the file handle
-        inFile.close();
-        return false;
+    if (!parseNumber(p, last, high) || high < 0)
+    {
+        os << "Error inserting high from line " << lineNo << endl;
+        return NULL;
     }
-
-    numLines = 0;
-    string line;
-    while (getline(inFile, line))
+    if (!parseNumber(p, last, low) || low < 0)
     {
-        numLines++;
-        stringstream input(line);
-        getline(input, symbol, ' ');
-        getline(input, company, ';');
-        input.ignore();
-        getline(input, date, ';');
-        // check for negative or non-numeric input data
-        // if there is any error loading the rest of the line,
-        // continue to next line 
-        input >> price;
-        if (input.fail() || price < 0) 
-        {
-            cout << "Error inserting price from line " << numLines << endl; 
-            continue; 
-        }
-        input >> high;
-        if (input.fail() || high < 0) 
-        {
-            cout << "Error inserting high from line " << numLines << endl;
-            continue;
-        }
-        input >> low;
-        if (input.fail() || low < 0) 
-        {
-            cout << "Error inserting low from line " << numLines << endl;
-            continue;
-        }
-        input >> change;
-        if (input.fail()) 
-        {
-            cout << "Error inserting change from line " << numLines << endl;
-            continue;
-        }
-        input >> volume;
-        if (input.fail() || volume < 0) 
-        {
-            cout << "Error inserting high from line " << volume << endl;
-            continue;
-        }
-        input >> yearHigh;
-        if (input.fail() || yearHigh < 0) 
-        {
-            cout << "Error inserting yearHigh from line " << numLines << endl;
-            continue;
-        }
-        input >> yearLow;
-        if (input.fail() || yearLow < 0) 
-        {
-            cout << "Error inserting yearLow from line " << numLines << endl;
-            continue;
-        }
-
-        Stock* stk = new Stock(symbol, company, date, price, high, low, change, volume, yearHigh, yearLow);
-        if (!stk) 
-        {
-            cout << "Error creating a Stock object from line " << numLines << endl;
-            continue;
-        }
-
-        // check if a stock with same symbol and date already exists in the hash
-        Stock* dataOut;
-        if (hash->search(*stk, dataOut) != -1) 
-        {
-            cout << "Error loading-a stock with the same symbol and date already exists-from line " << numLines << endl;
-            delete stk; // free memory
-            continue;
-        }
-
-        // checking if inserts are successful
-        if (!bst->insert(stk))
-        {
-            cout << "Error inserting item into BST from line " << numLines << "of input file" << endl;
-            delete stk; // free memory
-            continue;
-        }
-        if (!hash->insert(stk))
-        {
-            cout << "Error inserting item into Hash Table from line " << numLines << "of input file" << endl;
-            delete stk; // free memory
-            continue;
-        }
+        os << "Error inserting low from line " << lineNo << endl;
+        return NULL;
+    }
+    if (!parseNumber(p, last, change))
+    {
+        os << "Error inserting change from line " << lineNo << endl;
+        return NULL;
+    }
+    if (!parseNumber(p, last, volume) || volume < 0)
+    {
+        os << "Error inserting volume from line " << lineNo << endl;
+        return NULL;
+    }
+    if (!parseNumber(p, last, yearHigh) || yearHigh < 0)
+    {
+        os << "Error inserting yearHigh from line " << lineNo << endl;
+        return NULL;
+    }
+    if (!parseNumber(p, last, yearLow) || yearLow < 0)
+    {
+        os << "Error inserting yearLow from line " << lineNo << endl;
+        return NULL;
+    }
 
-        // reset values for future checks
-        price = -1;
-        high = -1;
-        low = -1;
-        change = -1;
-        yearHigh = -1;
-        yearLow = -1;
-        volume = -1;
-        symbol = "";
-        company = "";
-        date = "";
+    Stock* stk = pool.create(symbol, company, date, price, high, low, change, volume, yearHigh, yearLow);
+    if (!stk)
+    {
+        os << "Error creating a Stock object from line " << lineNo << endl;
+        return NULL;
     }
-    inFile.close();
-    
-    //hash->printHash();
-    //hash->showStatistics();
-    //bst->inOrder(hDisplay);
-    //bst->printTree(iDisplay);
-    //cout << endl;
 
-    return true;
+    return stk;
 }
 
 //**************************************************
-// add a Stock
-// -return true if successful, otherwise, false
+// a newline-aligned chunk of the DB file, with the Stock objects
+// and the error messages of its lines once it has been parsed
 //**************************************************
-bool StockDB::addStock()
+struct LoadChunk
 {
-    string symbol, company, date;
-    double price, high, low, change, yearHigh, yearLow;
-    int volume;
+    const char* first;                  // first character of the chunk
+    const char* last;                   // one past the last character
+    int firstLine;                      // line number of the first line
+    int numLines;                       // number of lines in the chunk
+    ObjectPool<Stock>* pool;            // pool of the parsed stocks
+    vector<Stock*> stocks;              // parsed stocks in line order
+    vector<int> stockLines;             // line number of each stock
+    vector<pair<int, string> > errors;  // parse errors in line order
+};
 
-    cout << "What is the symbol of the stock you would like to add or \"\" to quit? ";
-    string str;
-    cin.clear();
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    getline(cin, str);
-    str = trim(str);
-    if (!str.empty())
-    {
-        symbol = str;
-    }
-    else 
-    {
-        // user entered empty string, quit adding
-        return false;
+//**************************************************
+// count the lines in a chunk of the DB file
+// the last line does not need to end with a newline
+//**************************************************
+static void countLines(LoadChunk& chunk)
+{
+    int n = 0;
+    const char* p = chunk.first;
+    while (p < chunk.last) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', chunk.last - p));
+        n++;
+        p = nl ? nl + 1 : chunk.last;
     }
+    chunk.numLines = n;
+}
 
-    cout << "What is the name of the company? ";
-    //cin >> company; // this will not handle a string with spaces in it
-    while (company.empty()) 
+//**************************************************
+// parse all the lines in a chunk of the DB file
+// The Stock objects, their pool and the error messages are
+// kept in the chunk, so chunks can be parsed on any thread
+//**************************************************
+static void parseChunk(LoadChunk& chunk,
+                       Stock* parse(const char*, const char*, int, ostream&, ObjectPool<Stock>&))
+{
+    ostringstream err;
+    int lineNo = chunk.firstLine;
+    const char* p = chunk.first;
+    while (p < chunk.last)
     {
-        cin.clear();
-        getline(cin, str);
-        // trim the leading and trailing spaces
-        str = trim(str);
-        if (!str.empty()) 
-        {
-            company = str;
+        const char* nl = static_cast<const char*>(memchr(p, '\n', chunk.last - p));
+        const char* lineEnd = nl ? nl : chunk.last;
+        const char* next = nl ? nl + 1 : chunk.last;
+        // ignore the carriage return of a CRLF line
+        if (lineEnd > p && lineEnd[-1] == '\r') {
+            lineEnd--;
+        }
+
+        Stock* stk = parse(p, lineEnd, lineNo, err, *chunk.pool);
+        if (stk) {
+            chunk.stocks.push_back(stk);
+            chunk.stockLines.push_back(lineNo);
+        }
+        else {
+            chunk.errors.push_back(make_pair(lineNo, err.str()));
+            err.str("");
         }
+        lineNo++;
+        p = next;
     }
+}
 
-    cout << "When is the stock data from (mm/dd/year)? ";
-    cin >> date;
-    //there are multiple ways to write a date so we won't parse this one
+//**************************************************
+// report the load throughput
+//   - input params: the number of stocks loaded, the number of
+//                   lines or records read and their unit name,
+//                   the file size, the load start time, and
+//                   the number of threads
+//**************************************************
+static void reportLoad(int numStocks, int numLines, const char* unit, size_t size,
+                       chrono::steady_clock::time_point start, int numThreads)
+{
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double mbytes = size / (1024.0 * 1024.0);
+    ios_base::fmtflags flags = cout.flags();
+    streamsize prec = cout.precision();
+    cout << fixed << setprecision(2);
+    cout << "Loaded " << numStocks << " stocks from " << numLines << " " << unit << " ("
+         << mbytes << " MB) in " << secs * 1000 << " ms";
+    if (secs > 0) {
+        cout << " (" << mbytes / secs << " MB/s, "
+             << static_cast<long long>(numStocks / secs) << " stocks/s)";
+    }
+    if (numThreads > 1) {
+        cout << " using " << numThreads << " threads";
+    }
+    cout << endl;
+    cout.flags(flags);
+    cout.precision(prec);
+}
 
+//**************************************************
+// insert a Stock object parsed from a line of the DB file
+//   - input params: the Stock object, and its line number
+//   - return true if successful, otherwise, false
+//     the Stock object is freed if it is not inserted
+//**************************************************
+bool StockDB::loadStock(Stock* stk, int lineNo)
+{
     // check if a stock with same symbol and date already exists in the hash
-    Stock dataIn(symbol, "", date, 0, 0, 0, 0, 0, 0, 0);
     Stock* dataOut;
-    if (hash->search(dataIn, dataOut) != -1) 
+    if (hash->search(*stk, dataOut) != -1) 
     {
-        cout << "Stock with the same symbol and date already exists. Quit adding." << endl;
-        hDisplay(*dataOut);
+        cout << "Error loading-a stock with the same symbol and date already exists-from line " << lineNo << endl;
+        stockPool->destroy(stk); // free memory
         return false;
     }
 
-    // check for negative or non-numeric input data
-    cout << "What is the stock's price? ";
-    cin >> price;
-    if (cin.fail() || price < 0)
+    // checking if inserts are successful
+    if (!bst->insert(stk))
     {
-        cout << "Error inserting price. Aborting." << endl;
-        // clear buffer
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Error inserting item into BST from line " << lineNo << "of input file" << endl;
+        stockPool->destroy(stk); // free memory
         return false;
     }
-
-    cout << "What is the stock's high (for that day)? ";
-    cin >> high;
-    if (cin.fail() || high < 0)
+    if (!hash->insert(stk))
     {
-        cout << "Error inserting high. Aborting." << endl;
-        // clear buffer
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Error inserting item into Hash Table from line " << lineNo << "of input file" << endl;
+        stockPool->destroy(stk); // free memory
         return false;
     }
+    symbols->insert(stk);
+    movers->insert(stk);
+    columns->add(stk);
+    if (shared) {
+        shared->insert(stk);
+    }
 
-    cout << "What is the stock's low (for that day)? ";
-    cin >> low;
-    if (cin.fail() || low < 0)
-    {
-        cout << "Error inserting low. Aborting." << endl;
-        // clear buffer
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    return true;
+}
+
+//**************************************************
+// load database from a binary snapshot file in memory
+//   - input params: the snapshot filename, its contents and size
+//   - return true if successful, otherwise, false
+//     return the number of stocks loaded and records read
+//     via output parameters
+//**************************************************
+bool StockDB::loadSnapshotDB(const string& filename, const char* data, size_t size,
+                             int& numStocks, int& numRecords)
+{
+    // the stocks are created in a pool of their own
+    // and moved to the DB pool once the DB is created
+    ObjectPool<Stock> pool;
+    vector<Stock*> stocks;
+    string error;
+    if (!loadSnapshot(data, size, stocks, error, pool)) {
+        cout << "Error loading the snapshot file: \"" << filename << "\" (" << error << ")" << endl;
         return false;
     }
 
-    cout << "How much did the stock's price change (that day)? ";
-    cin >> change;
-    cout << "What the volume of the stock? ";
-    cin >> volume;
-    if (cin.fail() || volume < 0)
-    {
-        cout << "Error inserting volume. Aborting." << endl;
-        // clear buffer
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    // create an empty database
+    if (!initDB(HASH_SIZE)) {
+        cout << "Failed to create an empty StockDB" << endl;
+        for (size_t i = 0; i < stocks.size(); i++) {
+            pool.destroy(stocks[i]);
+        }
         return false;
     }
+    stockPool->merge(pool);
+    hash->reserve(static_cast<int>(stocks.size()));
+    columns->reserve(static_cast<int>(stocks.size()));
+
+    numRecords = static_cast<int>(stocks.size());
+    numStocks = 0;
+    for (size_t i = 0; i < stocks.size(); i++) {
+        if (loadStock(stocks[i], static_cast<int>(i) + 1)) {
+            numStocks++;
+        }
+    }
 
-    cout << "What is the stock's year high price? ";
-    cin >> yearHigh;
-    if (cin.fail() || yearHigh < 0)
+    return true;
+}
+
+//**************************************************
+// load database from a text or snapshot file
+// The file is mapped into memory once and split into
+// newline-aligned chunks. The chunks are parsed in parallel,
+// then merged into the bst and hash table in line order,
+// so duplicate detection and error messages are the same
+// as loading the file on one thread.
+//   - input params: filename - database file to load
+//                   numThreads - number of parser threads,
+//                                0 for all cores
+//   - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::loadFile(const string& filename, int numThreads)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    MappedFile inFile;
+    if (!inFile.open(filename))
+    {
+        cout << "Error opening the input file: \"" << filename << "\"" << endl;
+        return false;
+    }
+
+    const char* data = inFile.getData();
+    const char* end = data + inFile.getSize();
+
+    // a binary snapshot is loaded without text parsing
+    if (isSnapshot(data, inFile.getSize())) {
+        int numStocks = 0, numRecords = 0;
+        if (!loadSnapshotDB(filename, data, inFile.getSize(), numStocks, numRecords)) {
+            return false;
+        }
+        reportLoad(numStocks, numRecords, "records", inFile.getSize(), start, 1);
+        return true;
+    }
+
+    if (numThreads <= 0) {
+        numThreads = ThreadPool::hardwareThreads();
+    }
+
+    // split the file into newline-aligned chunks,
+    // a few per thread to balance the load
+    const size_t MIN_CHUNK_SIZE = 1 << 20;
+    size_t numChunks = (numThreads > 1) ? numThreads * 4 : 1;
+    if (inFile.getSize() / numChunks < MIN_CHUNK_SIZE) {
+        numChunks = inFile.getSize() / MIN_CHUNK_SIZE + 1;
+    }
+    vector<LoadChunk> chunks;
+    const char* p = data;
+    for (size_t i = 1; p < end; i++) {
+        const char* last = end;
+        if (i < numChunks) {
+            last = data + inFile.getSize() / numChunks * i;
+            if (last < p) {
+                last = p;
+            }
+            const char* nl = static_cast<const char*>(memchr(last, '\n', end - last));
+            last = nl ? nl + 1 : end;
+        }
+        LoadChunk chunk;
+        chunk.pool = NULL;
+        chunk.first = p;
+        chunk.last = last;
+        chunk.firstLine = 0;
+        chunk.numLines = 0;
+        chunks.push_back(chunk);
+        p = last;
+    }
+
+    // use a thread pool if there is more than one thread and chunk
+    ThreadPool* pool = NULL;
+    if (numThreads > 1 && chunks.size() > 1) {
+        pool = new ThreadPool(numThreads);
+    }
+
+    // count the lines to size the hash table
+    // and to number the lines of each chunk
+    for (size_t i = 0; i < chunks.size(); i++) {
+        if (pool) {
+            LoadChunk* chunk = &chunks[i];
+            pool->submit([chunk]() {countLines(*chunk);});
+        }
+        else {
+            countLines(chunks[i]);
+        }
+    }
+    if (pool) {
+        pool->wait();
+    }
+
+    int numLines = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        chunks[i].firstLine = numLines + 1;
+        numLines += chunks[i].numLines;
+    }
+
+    // return true if the input file is empty
+    if (numLines == 0) {
+        cout << "Input file is empty: \"" << filename << "\"" << endl;
+        delete pool;
+        return true;
+    }
+
+    // create an empty database
+    if (!initDB(HASH_SIZE)) {
+        cout << "Failed to create an empty StockDB" << endl;
+        delete pool;
+        return false;
+    }
+    hash->reserve(numLines);
+    columns->reserve(numLines);
+
+    // parse the chunks into Stock objects, in a pool per chunk
+    for (size_t i = 0; i < chunks.size(); i++) {
+        chunks[i].pool = new ObjectPool<Stock>();
+        if (pool) {
+            LoadChunk* chunk = &chunks[i];
+            pool->submit([chunk]() {parseChunk(*chunk, parseLine);});
+        }
+        else {
+            parseChunk(chunks[i], parseLine);
+        }
+    }
+    if (pool) {
+        pool->wait();
+        delete pool;
+    }
+
+    // move the stocks of the chunks to the DB pool
+    for (size_t i = 0; i < chunks.size(); i++) {
+        stockPool->merge(*chunks[i].pool);
+        delete chunks[i].pool;
+        chunks[i].pool = NULL;
+    }
+
+    // merge the chunks in line order
+    int numStocks = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        LoadChunk& chunk = chunks[i];
+        size_t e = 0;
+        for (size_t j = 0; j < chunk.stocks.size(); j++) {
+            // report the parse errors of the lines before this stock
+            while (e < chunk.errors.size() && chunk.errors[e].first < chunk.stockLines[j]) {
+                cout << chunk.errors[e].second;
+                e++;
+            }
+            if (loadStock(chunk.stocks[j], chunk.stockLines[j])) {
+                numStocks++;
+            }
+        }
+        while (e < chunk.errors.size()) {
+            cout << chunk.errors[e].second;
+            e++;
+        }
+    }
+
+    // report the load throughput
+    reportLoad(numStocks, numLines, "lines", inFile.getSize(), start,
+               chunks.size() > 1 ? numThreads : 1);
+
+    //hash->printHash();
+    //hash->showStatistics();
+    //bst->inOrder(hDisplay);
+    //bst->printTree(iDisplay);
+    //cout << endl;
+
+    return true;
+}
+
+//**************************************************
+// load database from a file to internal bst and hash table
+// then replay the write-ahead log written over the same file
+//   - input params: filename - database file to load
+//                   numThreads - number of parser threads,
+//                                0 for all cores
+//   - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::loadDB(const string& filename, int numThreads)
+{
+    if (!loadFile(filename, numThreads)) {
+        return false;
+    }
+
+    // the DB is usable without the log
+    openLog(filename);
+    return true;
+}
+
+//**************************************************
+// replay the write-ahead log if it was written over baseFile,
+// then open it to log the following changes
+// A non-empty log written over another file is kept as .old
+// and a new log is started
+//   - input param: baseFile - the DB file just loaded
+//   - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::openLog(const string& baseFile)
+{
+    if (!walEnabled) {
+        return true;
+    }
+
+    string logFile = dbFile + "." + DEF_WAL_FILEEXTN;
+    string logBase;
+    if (WriteAheadLog::readBase(logFile, logBase)) {
+        if (logBase == baseFile) {
+            long long n = WriteAheadLog::replay(logFile,
+                [this](char type, const char* first, const char* last) {
+                    replayRecord(type, first, last);
+                });
+            if (n > 0) {
+                cout << "Replayed " << n << " changes from " << logFile << endl;
+            }
+        }
+        else if (WriteAheadLog::replay(logFile, [](char, const char*, const char*) {}) > 0) {
+            string oldFile = logFile + ".old";
+            cout << "Write-ahead log " << logFile << " was written over " << logBase
+                 << ", not replayed. Kept as " << oldFile << endl;
+            rename(logFile.c_str(), oldFile.c_str());
+        }
+    }
+
+    if (!wal) {
+        wal = new WriteAheadLog();
+    }
+    wal->setSyncEvery(walSync);
+    if (!wal->open(logFile, baseFile)) {
+        cout << "Error opening the write-ahead log: \"" << logFile << "\"" << endl;
+        delete wal;
+        wal = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+//**************************************************
+// apply a write-ahead log record to the DB
+// The log is not open during the replay, so the
+// replayed changes are not logged again
+//   - input params: the record type, and the
+//                   character range of the payload
+//**************************************************
+void StockDB::replayRecord(char type, const char* first, const char* last)
+{
+    if (type == WriteAheadLog::DELETE_RECORD) {
+        // payload: symbol;date
+        const char* sep = static_cast<const char*>(memchr(first, ';', last - first));
+        if (sep) {
+            deleteSymbol(string_view(first, sep - first), string_view(sep + 1, last - sep - 1));
+        }
+        return;
+    }
+
+    if (type == WriteAheadLog::UNDO_RECORD && undoLastDelete()) {
+        return;
+    }
+
+    // an added stock, or an undo without a delete to undo
+    Stock* stk = parseLine(first, last, 0, cout, *stockPool);
+    if (stk && !addStock(stk)) {
+        stockPool->destroy(stk);
+    }
+}
+
+//**************************************************
+// append a change to the write-ahead log
+// the change is written to the log file by commitLog
+//   - input params: the record type, and the stock changed
+//**************************************************
+void StockDB::logChange(char type, const Stock& stk)
+{
+    if (!wal) {
+        return;
+    }
+
+    string payload;
+    if (type == WriteAheadLog::DELETE_RECORD) {
+        payload = stk.getSymbol() + ";" + stk.getDate();
+    }
+    else {
+        appendStockLine(payload, stk);
+    }
+    wal->append(type, payload);
+}
+
+//**************************************************
+// write the changes of an operation to the write-ahead log
+//**************************************************
+void StockDB::commitLog()
+{
+    if (wal && !wal->commit()) {
+        cout << "Error writing the write-ahead log" << endl;
+    }
+}
+
+//**************************************************
+// insert a stock into bst and hash table
+// the DB is created if it is not yet created
+//   - input param: the stock to insert
+//   - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::insertStock(Stock* stk)
+{
+    // the database is not yet created
+    if (!bst || !hash) {
+        // create an empty database
+        if (!initDB(HASH_SIZE)) {
+            cout << "Failed to create an empty StockDB" << endl;
+            return false;
+        }
+    }
+
+    if (!bst->insert(stk)) {
+        return false;
+    }
+    if (!hash->insert(stk)) {
+        Stock* b = NULL;
+        bst->remove(*stk, b);
+        return false;
+    }
+    symbols->insert(stk);
+    movers->insert(stk);
+    columns->add(stk);
+    if (shared) {
+        shared->insert(stk);
+    }
+
+    return true;
+}
+
+//**************************************************
+// remove a stock from hash table and bst by symbol and date
+//   - input param: the symbol and date to remove
+//   - return true if found, otherwise, false
+//     return the removed stock via output parameter
+//**************************************************
+bool StockDB::removeStock(const StockKey& key, Stock*& dataOut)
+{
+    if (!bst || !hash) {
+        return false;
+    }
+
+    // delete the item in the hash table by matching symbol and date
+    if (!hash->remove(key, dataOut)) {
+        return false;
+    }
+
+    // remove the item from bst by matching symbol and date
+    Stock* b = NULL;
+    if (!bst->remove(*dataOut, b)) {
+        // this should not happen
+        cout << "Failed to delete from bst" << endl;
+        return false;
+    }
+    symbols->remove(*dataOut, b);
+    movers->remove(dataOut);
+    columns->remove(dataOut);
+    if (shared) {
+        shared->remove(dataOut);
+    }
+
+    return true;
+}
+
+//**************************************************
+// add a Stock
+// -return true if successful, otherwise, false
+//**************************************************
+bool StockDB::addStock()
+{
+    string symbol, company, date;
+    double price, high, low, change, yearHigh, yearLow;
+    int volume;
+
+    cout << "What is the symbol of the stock you would like to add or \"\" to quit? ";
+    string str;
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, str);
+    str = trim(str);
+    if (!str.empty())
+    {
+        symbol = str;
+    }
+    else 
+    {
+        // user entered empty string, quit adding
+        return false;
+    }
+
+    cout << "What is the name of the company? ";
+    //cin >> company; // this will not handle a string with spaces in it
+    while (company.empty()) 
+    {
+        cin.clear();
+        getline(cin, str);
+        // trim the leading and trailing spaces
+        str = trim(str);
+        if (!str.empty()) 
+        {
+            company = str;
+        }
+    }
+
+    cout << "When is the stock data from (mm/dd/year)? ";
+    cin >> date;
+    //there are multiple ways to write a date so we won't parse this one
+
+    // check if a stock with same symbol and date already exists in the hash
+    Stock* dataOut = searchSymbol(symbol, date);
+    if (dataOut) 
+    {
+        cout << "Stock with the same symbol and date already exists. Quit adding." << endl;
+        hDisplay(*dataOut);
+        return false;
+    }
+
+    // check for negative or non-numeric input data
+    cout << "What is the stock's price? ";
+    cin >> price;
+    if (cin.fail() || price < 0)
+    {
+        cout << "Error inserting price. Aborting." << endl;
+        // clear buffer
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return false;
+    }
+
+    cout << "What is the stock's high (for that day)? ";
+    cin >> high;
+    if (cin.fail() || high < 0)
+    {
+        cout << "Error inserting high. Aborting." << endl;
+        // clear buffer
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return false;
+    }
+
+    cout << "What is the stock's low (for that day)? ";
+    cin >> low;
+    if (cin.fail() || low < 0)
+    {
+        cout << "Error inserting low. Aborting." << endl;
+        // clear buffer
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return false;
+    }
+
+    cout << "How much did the stock's price change (that day)? ";
+    cin >> change;
+    cout << "What the volume of the stock? ";
+    cin >> volume;
+    if (cin.fail() || volume < 0)
+    {
+        cout << "Error inserting volume. Aborting." << endl;
+        // clear buffer
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return false;
+    }
+
+    cout << "What is the stock's year high price? ";
+    cin >> yearHigh;
+    if (cin.fail() || yearHigh < 0)
     {
         cout << "Error inserting yearHigh. Aborting." << endl;
         // clear buffer
@@ -537,6 +1224,43 @@ bool StockDB::addStock()
         return false;
     }
 
+    Stock* stk = stockPool->create(symbol, company, date, price, high, low, change, volume, yearHigh, yearLow);
+    if (!stk)
+    {
+        cout << "Error creating a Stock object. Aborting. " << endl;
+        return false;
+    }
+
+    // checking if insert is successful
+    if (!addStock(stk))
+    {
+        cout << "Error inserting provided stock!" << endl;
+        stockPool->destroy(stk); // free memory
+        return false;
+    }
+
+    // Stock added successfully
+    cout << "Added:" << endl;
+    hDisplay(*stk);
+
+    return true;
+}
+
+//**************************************************
+// add a Stock object
+// the DB owns the stock object if it is added
+// - input param: the stock to add
+// - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::addStock(Stock* stk)
+{
+    // check if a stock with same symbol and date already exists in the hash
+    Stock* dataOut;
+    if (hash && hash->search(*stk, dataOut) != -1)
+    {
+        return false;
+    }
+
     // the database is not yet created
     if (!bst || !hash) {
         // create an empty database
@@ -546,105 +1270,407 @@ bool StockDB::addStock()
         }
     }
 
-    // rehash if load factor is greater than 75%
-    if (hash->getLoadFactor() > 75.0) {
-        rehash();
-    }
-
-    Stock* stk = new Stock(symbol, company, date, price, high, low, change, volume, yearHigh, yearLow);
-    if (!stk)
-    {
-        cout << "Error creating a Stock object. Aborting. " << endl;
-        return false;
+    if (!insertStock(stk))
+    {
+        return false;
+    }
+
+    // log the new stock
+    logChange(WriteAheadLog::ADD_RECORD, *stk);
+    commitLog();
+
+    return true;
+}
+
+//**************************************************
+// add a Stock from a line in the DB file format
+// - input params: the line, its line number for the error
+//                 messages, and the stream to report errors to
+// - return the new stock, or NULL if the line is invalid
+//   or the symbol and date already exist
+//**************************************************
+Stock* StockDB::addStock(string_view line, int lineNo, ostream& os)
+{
+    Stock* stk = parseLine(line.data(), line.data() + line.size(), lineNo, os, *stockPool);
+    if (!stk) {
+        return NULL;
+    }
+    if (!addStock(stk)) {
+        stockPool->destroy(stk);
+        return NULL;
+    }
+    return stk;
+}
+
+//**************************************************
+// search Stock by symbol and date
+//**************************************************
+void StockDB::searchSymbol() const
+{
+    string symbol;
+    string date;
+
+    // get Symbol from user
+    string str;
+    cout << "Please enter Symbol to search or \"\" to quit: ";
+
+    // clear buffer before getting new line
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, str);
+    str = trim(str);
+    if (!str.empty()) {
+        symbol = str;
+    }
+    else {
+        // user entered empty string, quit searching
+        return;
+    }
+    
+    // get date from user
+    bool done = false;
+    while (!done) {
+        string str;
+        cout << "Please enter date (mm/dd/year): ";
+        // clear buffer before getting new line
+        cin.clear();
+        getline(cin, str);
+        str = trim(str);
+        if (!str.empty()) {
+            date = str;
+            done = true;
+        }
+        else {
+            cout << "Empty date. Try again." << endl;
+        }
+    }
+
+    // search the symbol and date in the hash table
+    Stock* dataOut = searchSymbol(symbol, date);
+    if (dataOut) {
+        cout << "Found:" << endl;
+        hDisplay(*dataOut);
+    }
+    else {
+        cout << "Not found" << endl;
+    }
+}
+
+//**************************************************
+// search Stock by symbol and date in the hash table
+// The key refers to the strings, nothing is allocated
+// - input params: the symbol and date to search
+// - return the stock, or NULL if not found
+//**************************************************
+Stock* StockDB::searchSymbol(string_view symbol, string_view date) const
+{
+    Stock* dataOut = NULL;
+    if (!hash || hash->search(StockKey(symbol, date), dataOut) == -1) {
+        return NULL;
+    }
+    return dataOut;
+}
+
+//**************************************************
+// search a batch of stocks by symbol and date in the hash table
+// The hash table prefetches the buckets of a group of keys before
+// it searches them. A batch of at least MIN_THREAD_BATCH keys per
+// thread is split into one slice per thread, which search the table
+// at the same time without changing it. The threads are kept in
+// searchPool for the next batches
+// - input params: the keys to search, and the vector to fill
+// - return the number of stocks found, found[i] is the
+//   stock of keys[i], or NULL if not found
+//**************************************************
+int StockDB::searchSymbols(const vector<StockKey>& keys, vector<Stock*>& found) const
+{
+    int n = static_cast<int>(keys.size());
+    found.assign(n, NULL);
+    if (!hash || n == 0) {
+        return 0;
+    }
+
+    int poolSize = searchThreads > 0 ? searchThreads : ThreadPool::hardwareThreads();
+    int numThreads = min(poolSize, n / MIN_THREAD_BATCH);
+    if (numThreads <= 1) {
+        return hash->searchBatch(keys.data(), n, found.data());
+    }
+
+    // the number of threads may have been changed since the pool was created
+    if (searchPool && searchPool->getSize() != poolSize) {
+        delete searchPool;
+        searchPool = NULL;
+    }
+    if (!searchPool) {
+        searchPool = new ThreadPool(poolSize);
+    }
+
+    vector<int> numFound(numThreads, 0);
+    for (int t = 0; t < numThreads; t++) {
+        int lo = static_cast<int>(static_cast<long long>(n) * t / numThreads);
+        int hi = static_cast<int>(static_cast<long long>(n) * (t + 1) / numThreads);
+        const StockHash* table = hash;
+        const StockKey* k = keys.data();
+        Stock** f = found.data();
+        int* count = &numFound[t];
+        searchPool->submit([=]() {*count = table->findBatch(k + lo, hi - lo, f + lo);});
+    }
+    searchPool->wait();
+
+    int total = 0;
+    for (int t = 0; t < numThreads; t++) {
+        total += numFound[t];
+    }
+    return total;
+}
+
+//**************************************************
+// delete Stock by symbol and date
+//**************************************************
+void StockDB::deleteSymbol()
+{
+    string symbol;
+    string date;
+
+    // get Symbol from user
+    string str;
+    cout << "Please enter Symbol to delete or \"\" to quit: ";
+
+    // clear buffer before getting new line
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, str);
+    str = trim(str);
+    if (!str.empty()) {
+        symbol = str;
+    }
+    else {
+        // user entered empty string, quit searching
+        return;
+    }
+
+    // get date from user
+    bool done = false;
+    while (!done) {
+        string str;
+        cout << "Please enter date (mm/dd/year): ";
+        // clear buffer before getting new line
+        cin.clear();
+        getline(cin, str);
+        str = trim(str);
+        if (!str.empty()) {
+            date = str;
+            done = true;
+        }
+        else {
+            cout << "Empty date. Try again." << endl;
+        }
+    }
+
+    // delete the item by matching symbol and date
+    Stock* dataOut = deleteSymbol(symbol, date);
+    if (dataOut) {
+        cout << "Deleted:" << endl;
+        hDisplay(*dataOut);
+    }
+    else {
+        cout << "Not found" << endl;
+    }
+}
+
+//**************************************************
+// delete Stock by symbol and date
+// the deleted stock is pushed to the undo delete stack
+// - input params: the symbol and date to delete
+// - return the deleted stock, or NULL if not found
+//**************************************************
+Stock* StockDB::deleteSymbol(string_view symbol, string_view date)
+{
+    Stock* dataOut = NULL;
+    if (!removeStock(StockKey(symbol, date), dataOut)) {
+        return NULL;
+    }
+
+    // push the stock object to the stack
+    stack->push(dataOut);
+
+    // log the deleted stock
+    logChange(WriteAheadLog::DELETE_RECORD, *dataOut);
+    commitLog();
+
+    return dataOut;
+}
+
+//**************************************************
+// show the price indicators of a symbol
+//**************************************************
+void StockDB::showIndicators() const
+{
+    // get Symbol from user
+    string symbol;
+    cout << "Please enter Symbol or \"\" to quit: ";
+
+    // clear buffer before getting new line
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, symbol);
+    symbol = trim(symbol);
+    if (symbol.empty()) {
+        // user entered empty string, quit
+        return;
+    }
+
+    // get the date from user, empty for the last stock
+    string date;
+    cout << "Please enter the date (mm/dd/year) or \"\" for the last one: ";
+    bool done = false;
+    while (!done) {
+        cin.clear();
+        getline(cin, date);
+        date = trim(date);
+        int days;
+        if (date.empty() || parseDate(date, days)) {
+            done = true;
+        }
+        else {
+            cout << "Invalid date. Try again: ";
+        }
+    }
+
+    Indicators ind;
+    if (getIndicators(symbol, date, ind) <= 0) {
+        cout << "Not found" << endl;
+        return;
     }
+    ios_base::fmtflags flags = cout.flags();
+    streamsize prec = cout.precision();
+    cout << fixed << setprecision(2);
+    cout << "Indicators of " << symbol << " on " << ind.stock->getDate()
+         << " over " << ind.count << " stocks:" << endl;
+    cout << "SMA " << ind.sma << ", EMA " << ind.ema << ", VWAP " << ind.vwap << endl;
+    cout << "Bollinger bands " << ind.lower << " to " << ind.upper
+         << " (standard deviation " << ind.stddev << ")" << endl;
+    cout.flags(flags);
+    cout.precision(prec);
+}
 
-    // checking if inserts are successful
-    if (!bst->insert(stk))
-    {
-        cout << "Error inserting provided stock into BST!" << endl;
-        delete stk; // free memory
-        return false;
+//**************************************************
+// find the price indicators of a symbol
+// - input params: the symbol, the date (mm/dd/year) or an
+//                 empty date for the last stock of the symbol,
+//                 and the indicators to fill
+// - return 1 if found, 0 if the symbol has no stock on or
+//   before the date, or -1 if the date is invalid
+//**************************************************
+int StockDB::getIndicators(string_view symbol, string_view date, Indicators& out) const
+{
+    int days = INT_MAX;
+    if (!date.empty() && !parseDate(date, days)) {
+        return -1;
     }
-    if (!hash->insert(stk))
-    {
-        cout << "Error inserting provided stock into HashTable!" << endl;
-        delete stk; // free memory
-        return false;
+    if (!symbols) {
+        return 0;
     }
-
-    // Stock added successfully
-    cout << "Added:" << endl;
-    hDisplay(*stk);
-
-    return true;
+    return symbols->getIndicators(symbol, days, out) ? 1 : 0;
 }
 
 //**************************************************
-// search Stock by symbol and date
+// show the top gainers, losers and volume of a date
 //**************************************************
-void StockDB::searchSymbol() const
+void StockDB::showTopStocks() const
 {
-    string symbol;
+    // get the date from user
     string date;
-
-    // get Symbol from user
-    string str;
-    cout << "Please enter Symbol to search or \"\" to quit: ";
+    cout << "Please enter the date (mm/dd/year) or \"\" to quit: ";
 
     // clear buffer before getting new line
     cin.clear();
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    getline(cin, str);
-    str = trim(str);
-    if (!str.empty()) {
-        symbol = str;
-    }
-    else {
-        // user entered empty string, quit searching
-        return;
-    }
-    
-    // get date from user
     bool done = false;
     while (!done) {
-        string str;
-        cout << "Please enter date (mm/dd/year): ";
-        // clear buffer before getting new line
-        cin.clear();
-        getline(cin, str);
-        str = trim(str);
-        if (!str.empty()) {
-            date = str;
+        getline(cin, date);
+        date = trim(date);
+        int days;
+        if (date.empty()) {
+            // user entered empty string, quit
+            return;
+        }
+        if (parseDate(date, days)) {
             done = true;
         }
         else {
-            cout << "Empty date. Try again." << endl;
+            cout << "Invalid date. Try again: ";
+            cin.clear();
         }
     }
 
-    // search the symbol and date in the hash table
-    Stock dataIn(symbol, "", date, 0, 0, 0, 0, 0, 0, 0);
-    Stock* dataOut;
-    if (hash->search(dataIn, dataOut) != -1) {
-        cout << "Found:" << endl;
-        hDisplay(*dataOut);
+    for (int r = 0; r < TopStocks::NUM_RANKINGS; r++) {
+        vector<Stock*> found;
+        int n = getTopStocks(r, date, TopStocks::DEF_K, found);
+        if (n <= 0) {
+            cout << "No stocks on " << date << endl;
+            return;
+        }
+        cout << "Top " << TopStocks::getRankingName(static_cast<TopStocks::Ranking>(r))
+             << " on " << date << ": (" << n << " stocks)" << endl;
+        hDisplay(found, cout);
     }
-    else {
-        cout << "Not found" << endl;
+}
+
+//**************************************************
+// find the first stocks of a ranking on a date
+// - input params: the TopStocks ranking, the date (mm/dd/year),
+//                 the number of stocks, and the vector to append
+//                 the stocks found to
+// - return the number of stocks found, or -1 if the date is invalid
+//**************************************************
+int StockDB::getTopStocks(int ranking, string_view date, int n, vector<Stock*>& found) const
+{
+    int days;
+    if (!parseDate(date, days)) {
+        return -1;
     }
+    if (!movers) {
+        return 0;
+    }
+    return movers->getTop(static_cast<TopStocks::Ranking>(ranking), days, n, found);
 }
 
 //**************************************************
-// delete Stock by symbol and date
+// the stocks of a date with the largest change, the smallest
+// change, or the largest volume
+// - input params: the date (mm/dd/year), the number of stocks,
+//                 and the vector to append the stocks found to
+// - return the number of stocks found, or -1 if the date is invalid
 //**************************************************
-void StockDB::deleteSymbol()
+int StockDB::getGainers(string_view date, int n, vector<Stock*>& found) const
+{
+    return getTopStocks(TopStocks::GAINERS, date, n, found);
+}
+
+int StockDB::getLosers(string_view date, int n, vector<Stock*>& found) const
+{
+    return getTopStocks(TopStocks::LOSERS, date, n, found);
+}
+
+int StockDB::getVolumeLeaders(string_view date, int n, vector<Stock*>& found) const
+{
+    return getTopStocks(TopStocks::VOLUME, date, n, found);
+}
+
+//**************************************************
+// search the stocks of a symbol in a date range
+//**************************************************
+void StockDB::searchRange() const
 {
     string symbol;
-    string date;
+    string dates[2];
+    const char* prompts[2] = {"Please enter the first date (mm/dd/year): ",
+                              "Please enter the last date (mm/dd/year): "};
 
     // get Symbol from user
     string str;
-    cout << "Please enter Symbol to delete or \"\" to quit: ";
+    cout << "Please enter Symbol to search or \"\" to quit: ";
 
     // clear buffer before getting new line
     cin.clear();
@@ -659,46 +1685,61 @@ void StockDB::deleteSymbol()
         return;
     }
 
-    // get date from user
-    bool done = false;
-    while (!done) {
-        string str;
-        cout << "Please enter date (mm/dd/year): ";
-        // clear buffer before getting new line
-        cin.clear();
-        getline(cin, str);
-        str = trim(str);
-        if (!str.empty()) {
-            date = str;
-            done = true;
-        }
-        else {
-            cout << "Empty date. Try again." << endl;
+    // get the first and last dates from user
+    for (int i = 0; i < 2; i++) {
+        bool done = false;
+        while (!done) {
+            cout << prompts[i];
+            cin.clear();
+            getline(cin, str);
+            str = trim(str);
+            int days;
+            if (parseDate(str, days)) {
+                dates[i] = str;
+                done = true;
+            }
+            else {
+                cout << "Invalid date. Try again." << endl;
+            }
         }
     }
 
-    // delete the item in the hash table by matching symbol
-    Stock dataIn(symbol, "", date, 0, 0, 0, 0, 0, 0, 0);
-    Stock* dataOut = NULL;
-    if (hash->remove(dataIn, dataOut)) {
-        Stock* b = NULL;
-        // remove the item from bst by matching symbol and date
-        if (bst->remove(*dataOut, b)) {
-            cout << "Deleted:" << endl;
-            hDisplay(*dataOut);
-            // push the book object to the stack
-            stack->push(b);
-        }
-        else {
-            // this should not happen
-            cout << "Failed to delete from bst" << endl;
+    // search the date range in the symbol index
+    vector<Stock*> found;
+    int n = searchRange(symbol, dates[0], dates[1], found);
+    if (n > 0) {
+        cout << "Found: ";
+        if (n > 1) {
+            cout << "(" << n << " stocks)";
         }
+        cout << endl;
+        hDisplay(found, cout);
     }
     else {
         cout << "Not found" << endl;
     }
 }
 
+//**************************************************
+// search the stocks of a symbol in a date range
+// - input params: the symbol, the first and last dates
+//                 (mm/dd/year, both included), and the
+//                 vector to append the stocks found to
+// - return the number of stocks found, or -1 if a date is invalid
+//**************************************************
+int StockDB::searchRange(string_view symbol, string_view fromDate,
+                         string_view toDate, vector<Stock*>& found) const
+{
+    int fromDays, toDays;
+    if (!parseDate(fromDate, fromDays) || !parseDate(toDate, toDays)) {
+        return -1;
+    }
+    if (!symbols) {
+        return 0;
+    }
+    return symbols->rangeSearch(symbol, fromDays, toDays, found);
+}
+
 //**************************************************
 // search Stock by company name
 //**************************************************
@@ -715,20 +1756,14 @@ void StockDB::searchCompany() const
 
     if (!str.empty()) {
         // search the company name in the bst
-        Stock dataIn("", str, "", 0, 0, 0, 0, 0, 0, 0);
-        LinkedList<Stock> dataList;
-        if (bst->search(dataIn, dataList)) {
+        const vector<Stock*>* stocks = searchCompany(str);
+        if (stocks) {
             cout << "Found: ";
-            if (dataList.getLength() > 1) {
-                cout << "(" << dataList.getLength() << " stocks)";
+            if (stocks->size() > 1) {
+                cout << "(" << stocks->size() << " stocks)";
             }
             cout << endl;
-            const ListNode<Stock>* cur = dataList.getHead()->getNext();
-            while (cur) {
-                Stock* b = cur->getItem();
-                hDisplay(*b);
-                cur = cur->getNext();
-            }
+            hDisplay(*stocks, cout);
         }
         else {
             cout << "Not found" << endl;
@@ -736,6 +1771,20 @@ void StockDB::searchCompany() const
     }
 }
 
+//**************************************************
+// search the stocks of a company in the bst
+// - input param: the company name
+// - return the stocks sorted by symbol + date,
+//   NULL if there is no such company
+//**************************************************
+const vector<Stock*>* StockDB::searchCompany(string_view company) const
+{
+    if (!bst) {
+        return NULL;
+    }
+    return bst->search(company);
+}
+
 //**************************************************
 // delete Stock by company name
 //**************************************************
@@ -751,39 +1800,15 @@ void StockDB::deleteCompany()
     str = trim(str);
 
     if (!str.empty()) {
-        // search the company name in the bst
-        Stock dataIn("", str, "", 0, 0, 0, 0, 0, 0, 0);
-        LinkedList<Stock> dataList;
-        if (bst->search(dataIn, dataList)) {
+        vector<Stock*> deleted;
+        int n = deleteCompany(str, deleted);
+        if (n) {
             cout << "Deleted: ";
-            if (dataList.getLength() > 1) {
-                cout << "(" << dataList.getLength() << " stocks)";
+            if (n > 1) {
+                cout << "(" << n << " stocks)";
             }
             cout << endl;
-            const ListNode<Stock>* cur = dataList.getHead()->getNext();
-            while (cur) {
-                Stock* b = cur->getItem();
-                Stock* dataOut = NULL;
-                // remove the item from bst
-                if (bst->remove(*b, dataOut)) {
-                    dataOut = NULL;
-                    // remove the item from hash
-                    if (hash->remove(*b, dataOut)) {
-                        hDisplay(*b);
-                        // push the book object to the stack
-                        stack->push(b);
-                    }
-                    else {
-                        // this should not happen
-                        cout << "Failed to delete from hash" << endl;
-                    }
-                }
-                else {
-                    // this should not happen
-                    cout << "Failed to delete from bst" << endl;
-                }
-                cur = cur->getNext();
-            }
+            hDisplay(deleted, cout);
         }
         else {
             cout << "Not found" << endl;
@@ -792,24 +1817,46 @@ void StockDB::deleteCompany()
 }
 
 //**************************************************
-// rehash internal hash table to 2 times of current size
+// delete all the stocks of a company
+// The deleted stocks are pushed to the undo delete stack
+// and written to the write-ahead log in one commit
+// - input params: the company name to delete, and
+//                 the vector to append the deleted stocks to
+// - return the number of stocks deleted
 //**************************************************
-bool StockDB::rehash()
+int StockDB::deleteCompany(string_view company, vector<Stock*>& deleted)
 {
-    if (hash) {
-        int hashSize = nextPrime(2 * hash->getSize());
-        if (!hash->rehash(hashSize)) {
-            cout << "Failed to rehash HashTable in BookDB" << endl;
-            return false;
+    if (!bst || !hash) {
+        return 0;
+    }
+
+    // remove the company and all its stocks from the bst at once
+    vector<Stock*> stocks;
+    if (!bst->removeCompany(company, stocks)) {
+        return 0;
+    }
+
+    int n = 0;
+    for (size_t i = 0; i < stocks.size(); i++) {
+        Stock* dataOut = NULL;
+        if (hash->remove(*stocks[i], dataOut)) {
+            Stock* b = NULL;
+            symbols->remove(*dataOut, b);
+            movers->remove(dataOut);
+            columns->remove(dataOut);
+            if (shared) {
+                shared->remove(dataOut);
+            }
+            // push the stock object to the stack
+            stack->push(dataOut);
+            deleted.push_back(dataOut);
+            logChange(WriteAheadLog::DELETE_RECORD, *dataOut);
+            n++;
         }
-        /* DEBUG
-        hash->printHash(hDisplay);
-        hash->printStatistics();
-        cout << endl;
-        */
     }
+    commitLog();
 
-    return true;
+    return n;
 }
 
 //**************************************************
@@ -823,8 +1870,8 @@ void StockDB::undoDelete()
         return;
     }
 
-    Stock* b = stack->pop();
-    if (hash->insert(b) && bst->insert(b)) {
+    Stock* b = undoLastDelete();
+    if (b) {
         cout << "Book undeleted:" << endl;
         hDisplay(*b);
     }
@@ -834,7 +1881,35 @@ void StockDB::undoDelete()
 }
 
 //**************************************************
-// save DB to a file
+// undo the last delete
+// A stock with the same symbol and date added after the
+// delete blocks the undo: the deleted stock is kept on
+// the stack and nothing is logged
+// - return the undeleted stock, or NULL if there is
+//   no deletion to undo or it cannot be inserted
+//**************************************************
+Stock* StockDB::undoLastDelete()
+{
+    if (!stack || stack->isEmpty() || !hash) {
+        return NULL;
+    }
+
+    Stock* b = stack->pop();
+    Stock* dataOut;
+    if (hash->search(StockKey(*b), dataOut) != -1 || !insertStock(b)) {
+        stack->push(b);
+        return NULL;
+    }
+
+    // log the undeleted stock
+    logChange(WriteAheadLog::UNDO_RECORD, *b);
+    commitLog();
+
+    return b;
+}
+
+//**************************************************
+// save DB to a file on a background thread
 // - input param: an option to use default output filename
 //                instead of asking user to enter
 //                a filename to save to
@@ -855,16 +1930,152 @@ void StockDB::saveToFile(bool useDef)
     if (str.empty()) {
         str = dbFile;
     }
-    string filename = str + "." + dbExtn;
+    if (startSave(str, cout)) {
+        cout << "Saving " << getNumStocks() << " stocks to " << str << "." << dbExtn
+             << " in the background (V - show the progress)" << endl;
+    }
+}
+
+//**************************************************
+// save DB to a text file and a binary snapshot
+// - input params: the filename without extension,
+//                 and the stream to report to
+// - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::saveDB(const string& name, ostream& os)
+{
+    return startSave(name, os) && finishSave(os);
+}
+
+//**************************************************
+// start saving DB to a text file and a binary snapshot
+// on a background thread
+// The list of the stocks is the point-in-time copy that is
+// saved: the Stock objects do not change while they are in
+// the DB, and freeDB waits for the save before freeing them
+// - input params: the filename without extension,
+//                 and the stream to report to
+// - return true if the save started, otherwise, false
+//**************************************************
+bool StockDB::startSave(const string& name, ostream& os)
+{
+    if (!hash) {
+        os << "Empty Stock database" << endl;
+        return false;
+    }
+    if (saver->isRunning()) {
+        os << "A save is already in progress" << endl;
+        return false;
+    }
+    if (saver->isOver()) {
+        finishSave(os);
+    }
+
+    // the snapshot point: the stocks, and the end of the log
+    vector<Stock*> stocks;
+    hash->getItems(stocks);
+    saveLogSize = wal ? wal->getSize() : 0;
+    saveLogRecords = wal ? wal->getNumRecords() : 0;
+
+    // save the text file, and a binary snapshot next to it
+    // for a fast restart; existing files are overwritten
+    return saver->start(name + "." + dbExtn, name + "." + DEF_SNAP_FILEEXTN, stocks);
+}
+
+//**************************************************
+// wait for the background save to end and report it
+// - input param: the stream to report to
+// - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::finishSave(ostream& os)
+{
+    if (saver->getState() == BackgroundSaver::IDLE) {
+        return false;
+    }
+    bool ok = saver->finish(os);
+
+    // the changes before the snapshot are no longer needed,
+    // the ones made while it was saved are kept
+    if (ok && wal && !wal->rotate(saver->getSnapFile(), saveLogSize, saveLogRecords)) {
+        os << "Error rotating the write-ahead log" << endl;
+    }
+    return ok;
+}
 
-    // save DB to a file
-    // if the file already exists, overwrite it
-    if (hash->saveToFile(filename)) {
-        cout << "Saved Stock database to " << filename << endl;
+//**************************************************
+// set the order of the stocks in the saved files
+// - input param: the order, "key", "company" or "hash"
+// - return false if the order is unknown
+//**************************************************
+bool StockDB::setSaveOrder(const string& order)
+{
+    if (order == "key") {
+        saver->setOrder(BackgroundSaver::KEY_ORDER);
+    }
+    else if (order == "company") {
+        saver->setOrder(BackgroundSaver::COMPANY_ORDER);
+    }
+    else if (order == "hash") {
+        saver->setOrder(BackgroundSaver::HASH_ORDER);
     }
     else {
-        cout << "Error saving Stock database" << endl;
+        return false;
+    }
+    return true;
+}
+
+//**************************************************
+// set the number of threads the saved files are sorted
+// and formatted on, 0 for one per core
+//**************************************************
+void StockDB::setSaveThreads(int n)
+{
+    saver->setNumThreads(n);
+}
+
+//**************************************************
+// show the progress of the background save
+//**************************************************
+void StockDB::showSaveProgress() const
+{
+    saver->showProgress(cout);
+}
+
+//**************************************************
+// check if a background save is still running
+//**************************************************
+bool StockDB::isSaving() const
+{
+    return saver->isRunning();
+}
+
+//**************************************************
+// number of stocks in the DB
+//**************************************************
+int StockDB::getNumStocks() const
+{
+    return hash ? hash->getCount() : 0;
+}
+
+//**************************************************
+// build the index for reader threads from the stocks in the DB
+// It is kept up to date by the adds, deletes and undos
+// - return true if successful, otherwise, false
+//**************************************************
+bool StockDB::enableConcurrentReads()
+{
+    if (!hash) {
+        return false;
+    }
+    if (shared) {
+        delete shared;
     }
+
+    vector<Stock*> stocks;
+    hash->getItems(stocks);
+    shared = new ConcurrentIndex(static_cast<int>(stocks.size()));
+    shared->build(stocks);
+    return true;
 }
 
 //**************************************************
@@ -873,5 +2084,94 @@ void StockDB::saveToFile(bool useDef)
 void StockDB::showStatistics() const
 {
     hash->showStatistics();
+
+    // compare the hash policies on the same stocks
+    cout << "Hash policies over " << hash->getSize() << " buckets:" << endl;
+    hash->showDistribution<CharSumHash<Stock> >("CharSumHash (modulo)");
+    hash->showDistribution<WyHash<Stock> >("WyHash (multiply-shift)");
+}
+
+//**************************************************
+// show the count, min, max and average of each numeric field
+// The aggregates are scans of the column store,
+// which do not visit the Stock objects
+//**************************************************
+void StockDB::showSummary() const
+{
+    cout << "Summary of " << columns->getCount() << " stocks:" << endl;
+    cout << left << " " << setw(10) << "Field" << " ";
+    cout << right << " " << setw(14) << "Min" << " ";
+    cout << " " << setw(14) << "Max" << " ";
+    cout << " " << setw(14) << "Average" << " " << endl;
+    cout << fixed << setprecision(2);
+    for (int f = 0; f < StockColumns::NUM_FIELDS; f++) {
+        StockColumns::Field field = static_cast<StockColumns::Field>(f);
+        StockColumns::Summary s = columns->summarize(field);
+        cout << left << " " << setw(10) << StockColumns::getFieldName(field) << " ";
+        cout << right << " " << setw(14) << s.min << " ";
+        cout << " " << setw(14) << s.max << " ";
+        cout << " " << setw(14) << s.getAverage() << " " << endl;
+    }
+    cout << left;
+}
+
+//**************************************************
+// screen the stocks by conditions on their numeric fields
+//**************************************************
+void StockDB::screenStocks() const
+{
+    string str;
+    cout << "Please enter the conditions (e.g. change > 2 volume > 5000000 "
+            "price >= 0.95 yearhigh) or \"\" to quit: ";
+
+    // clear buffer before getting new line
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, str);
+    str = trim(str);
+    if (str.empty()) {
+        return;
+    }
+
+    Screener screener;
+    string error;
+    if (!screener.parse(str, error)) {
+        cout << "Invalid conditions: " << error << endl;
+        cout << "The fields are price, high, low, change, volume, yearhigh "
+                "and yearlow, the operators >, >=, < and <=" << endl;
+        return;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<Stock*> found;
+    int n = screenStocks(screener, found);
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    hDisplay(found, cout);
+    cout << fixed << setprecision(2);
+    cout << n << " of " << columns->getCount() << " stocks found in " << us << " us ("
+         << Screener::getKernelName(screener.getKernel()) << ")" << endl;
+}
+
+//**************************************************
+// the stocks that meet the conditions of a screener
+// The screener runs over the column store
+// - input params: the screener, and the vector to append
+//                 the stocks found to
+// - return the number of stocks found
+//**************************************************
+int StockDB::screenStocks(const Screener& screener, vector<Stock*>& found) const
+{
+    if (!columns) {
+        return 0;
+    }
+
+    vector<int> rows;
+    int n = screener.select(*columns, rows);
+    found.reserve(found.size() + n);
+    for (int i = 0; i < n; i++) {
+        found.push_back(columns->getStock(rows[i]));
+    }
+    return n;
 }
 
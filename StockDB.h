@@ -7,28 +7,106 @@
 #ifndef Stock_DB_H_
 #define Stock_DB_H_
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 // Forward Declaration
 class Stock;
 
-template<class ItemType>
-class BinarySearchTree;
+struct StockKey;
+
+class CompanyIndex;
+
+class SymbolIndex;
+
+class TopStocks;
+
+struct Indicators;
+
+class StockColumns;
+
+class Screener;
+
+class ConcurrentIndex;
 
 template<class ItemType>
+struct WyHash;
+
+template<class ItemType, class HashPolicy>
 class HashTable;
 
 template<class ItemType>
 class Stack;
 
+template<class ItemType>
+class ListNode;
+
+template<class T>
+class ObjectPool;
+
+class WriteAheadLog;
+
+class BackgroundSaver;
+
+class ThreadPool;
+
 class StockDB
 {
 private:
-    // BST and hash table
-    BinarySearchTree<Stock>* bst;
-    HashTable<Stock>* hash;
+    // hash table indexed by symbol + date with the WyHash policy
+    typedef HashTable<Stock, WyHash<Stock> > StockHash;
+
+    // BST (an AVL tree with one node per company name) and hash table
+    CompanyIndex* bst;
+    StockHash* hash;
+
+    // stocks of each symbol sorted by date, for date range queries
+    SymbolIndex* symbols;
+
+    // the top gainers, losers and volume of each date
+    TopStocks* movers;
+
+    // numeric fields of the stocks in one array per field,
+    // for scans and aggregates over all the stocks
+    StockColumns* columns;
+
+    // copy-on-write index for reader threads, NULL until
+    // enableConcurrentReads is called
+    ConcurrentIndex* shared;
 
     // Undo delete stack
     Stack<Stock>* stack;
 
+    // pools of the Stock objects and the hash table list nodes,
+    // so a record is not two heap allocations and the DB is freed
+    // a slab at a time
+    ObjectPool<Stock>* stockPool;
+    ObjectPool<ListNode<Stock> >* nodePool;
+
+    // write-ahead log of the changes since the DB file was loaded
+    WriteAheadLog* wal;
+
+    // saves the DB on a background thread, and the size and number
+    // of records of the write-ahead log when the save started
+    BackgroundSaver* saver;
+    long long saveLogSize;
+    long long saveLogRecords;
+
+    // write-ahead log options
+    bool walEnabled;
+    int walSync;
+
+    // rows per page of the sorted table display, 0 for all the rows
+    int pageSize;
+
+    // threads a large batch of lookups is split over, 0 for all cores
+    int searchThreads;
+
+    // the threads of the batch lookups, created by the first
+    // batch large enough to be split, NULL until then
+    mutable ThreadPool* searchPool;
+
     // default DB output filename
     string dbFile;
 
@@ -38,12 +116,21 @@ private:
     // default hash size
     static const int HASH_SIZE = 101;
 
+    // the fewest lookups of a batch given to each thread
+    static const int MIN_THREAD_BATCH = 1 << 14;
+
     // default DB output filename
     const string DEF_DB_FILENAME = "outStockDB";
 
     // default DB file extension
     const string DEF_DB_FILEEXTN = "txt";
 
+    // binary snapshot file extension
+    const string DEF_SNAP_FILEEXTN = "sdb";
+
+    // write-ahead log file extension
+    const string DEF_WAL_FILEEXTN = "wal";
+
 private:
     // free database memory
     void freeDB();
@@ -51,6 +138,43 @@ private:
     // create an empty DB
     bool initDB(int hashSize);
 
+    // parse one line of the DB file into a new Stock object in pool
+    // return NULL and report the error to os if the line is invalid
+    static Stock* parseLine(const char* first, const char* last, int lineNo, ostream& os,
+                            ObjectPool<Stock>& pool);
+
+    // insert a Stock object parsed from the given line of the DB file
+    // return false and free the Stock if it cannot be inserted
+    bool loadStock(Stock* stk, int lineNo);
+
+    // load database from a binary snapshot file in memory
+    // return the number of stocks loaded and records read
+    bool loadSnapshotDB(const string& filename, const char* data, size_t size,
+                        int& numStocks, int& numRecords);
+
+    // load database from a text or snapshot file
+    bool loadFile(const string& filename, int numThreads);
+
+    // insert a stock into bst and hash table,
+    // creating the DB if it is not yet created
+    bool insertStock(Stock* stk);
+
+    // remove a stock from hash table and bst by symbol and date
+    bool removeStock(const StockKey& key, Stock*& dataOut);
+
+    // append the first n stocks of a TopStocks ranking on a date
+    // return the number of stocks found, or -1 if the date is invalid
+    int getTopStocks(int ranking, string_view date, int n, vector<Stock*>& found) const;
+
+    // apply a write-ahead log record to the DB
+    void replayRecord(char type, const char* first, const char* last);
+
+    // append a change to the write-ahead log
+    void logChange(char type, const Stock& stk);
+
+    // write the logged changes of an operation to the write-ahead log
+    void commitLog();
+
 public:
     StockDB();
     ~StockDB();
@@ -58,6 +182,19 @@ public:
     // setters
     void setDBFile(const string& name) {dbFile = name;}
     void setDBExtn(const string& ext) {dbExtn = ext;}
+    void setLogEnabled(bool enabled) {walEnabled = enabled;}
+    void setLogSync(int n) {walSync = n;}
+    void setPageSize(int n) {pageSize = n;}
+    void setSearchThreads(int n) {searchThreads = n;}
+
+    // set the order of the stocks in the saved files: "key" (symbol
+    // + date, the default), "company" (company name, then symbol +
+    // date) or "hash" (hash table order, unsorted)
+    // return false if the order is unknown
+    bool setSaveOrder(const string& order);
+
+    // sort and format the saved files on n threads (0 for all cores)
+    void setSaveThreads(int n);
 
     // getters
     string getDBFile() const {return dbFile;}
@@ -70,9 +207,20 @@ public:
     void mainMenu();
 
     // display sorted data by company name
-    // as a table, with header and footer included
+    // as a table, with header and footer included,
+    // a page at a time if the page size is set
     void displayDB() const;
 
+    // write up to limit rows of the table of the stocks sorted by
+    // company name, from row offset (0 for the first), with the header
+    // return the number of rows written
+    int displayDB(ostream& os, long long offset, int limit) const;
+
+    // append up to limit stocks sorted by company name,
+    // from row offset (0 for the first)
+    // return the number of stocks appended
+    int getSortedStocks(long long offset, int limit, vector<Stock*>& stocks) const;
+
     // display BST as an indented list
     void displayBST() const;
 
@@ -80,37 +228,151 @@ public:
     void displayHash() const;
 
     // load database from a file to internal bst and hash table
-    bool loadDB(const string& filename);
+    // the lines are parsed on numThreads threads (0 for all cores)
+    // then the write-ahead log is replayed and opened
+    bool loadDB(const string& filename, int numThreads = 1);
+
+    // replay the write-ahead log if it was written over baseFile,
+    // then open it to log the following changes
+    bool openLog(const string& baseFile);
 
     // add a stock
     bool addStock();
 
+    // add a stock object, the DB owns it if successful
+    // return false if the symbol and date already exist
+    bool addStock(Stock* stk);
+
+    // add a stock from a line in the DB file format
+    // return the new stock, or NULL if the line is invalid (the
+    // error is written to os) or the symbol and date already exist
+    Stock* addStock(string_view line, int lineNo, ostream& os);
+
     // search stock by symbol and date
     void searchSymbol() const;
 
+    // search stock by symbol and date, without allocating memory
+    // return the stock, or NULL if not found
+    Stock* searchSymbol(string_view symbol, string_view date) const;
+
+    // search many stocks by symbol and date at once, faster than one
+    // searchSymbol per key; a large batch is split over the search
+    // threads; found[i] is the stock of keys[i], or NULL if not found
+    // return the number of stocks found
+    int searchSymbols(const vector<StockKey>& keys, vector<Stock*>& found) const;
+
     // delete stock by symbol and date
     void deleteSymbol();
 
+    // delete stock by symbol and date
+    // return the deleted stock, or NULL if not found
+    Stock* deleteSymbol(string_view symbol, string_view date);
+
+    // search the stocks of a symbol in a date range
+    void searchRange() const;
+
+    // search the stocks of a symbol from one date to another
+    // (mm/dd/year, both included), in date order
+    // return the number of stocks found, or -1 if a date is invalid
+    int searchRange(string_view symbol, string_view fromDate,
+                    string_view toDate, vector<Stock*>& found) const;
+
+    // show the top gainers, losers and volume of a date
+    void showTopStocks() const;
+
+    // the n stocks of a date with the largest change, the smallest
+    // change, or the largest volume, in that order; O(n) for up to
+    // 20 stocks, which are kept up to date for every date
+    // return the number of stocks found, or -1 if the date is invalid
+    int getGainers(string_view date, int n, vector<Stock*>& found) const;
+    int getLosers(string_view date, int n, vector<Stock*>& found) const;
+    int getVolumeLeaders(string_view date, int n, vector<Stock*>& found) const;
+
+    // show the price indicators of a symbol
+    void showIndicators() const;
+
+    // the price indicators of a symbol over its last 20 stocks: SMA,
+    // EMA, VWAP and Bollinger bands, kept up to date as stocks are
+    // added and deleted; at its last stock on or before a date
+    // (mm/dd/year), or at its last stock if the date is empty
+    // return 1 if found, 0 if the symbol has no stock on or
+    // before the date, or -1 if the date is invalid
+    int getIndicators(string_view symbol, string_view date, Indicators& out) const;
+
     // search stock by company name
     void searchCompany() const;
 
+    // search the stocks of a company, without allocating memory
+    // return the stocks sorted by symbol + date, NULL if none
+    const vector<Stock*>* searchCompany(string_view company) const;
+
     // delete stock by company name
     void deleteCompany();
 
-    // rehash internal hash table to 2 times of current size
-    bool rehash();
+    // delete all the stocks of a company
+    // return the number of stocks deleted and the stocks
+    int deleteCompany(string_view company, vector<Stock*>& deleted);
 
     // undo delete
     void undoDelete();
 
+    // undo the last delete
+    // return the undeleted stock, or NULL if there is none
+    Stock* undoLastDelete();
+
     // save DB to a file
     // ask user to input a filename if useDef is false
     // otherwise, use the default output DB filename
     void saveToFile(bool useDef = false);
 
+    // save DB to the text file name.extension and a snapshot
+    // next to it, and report to os
+    // return false if either file cannot be written
+    bool saveDB(const string& name, ostream& os);
+
+    // start saving DB like saveDB on a background thread
+    // the DB can be changed while it is saved
+    // return false if the DB is empty or a save is in progress
+    bool startSave(const string& name, ostream& os);
+
+    // wait for the background save to end and report to os,
+    // then drop the log records that are in the saved snapshot
+    // return false if the save failed or none was started
+    bool finishSave(ostream& os);
+
+    // show the progress of the background save
+    void showSaveProgress() const;
+
+    // check if a background save is still running
+    bool isSaving() const;
+
+    // number of stocks in the DB
+    int getNumStocks() const;
+
+    // build an index that reader threads can search while this
+    // thread keeps adding and deleting stocks; the readers must
+    // stop before the DB is loaded again or destroyed
+    // return false if the DB is not created
+    bool enableConcurrentReads();
+
+    // the index for reader threads, NULL if not enabled
+    // reader threads search it through a ConcurrentIndex::Reader
+    const ConcurrentIndex* getConcurrentIndex() const {return shared;}
+
     // show statistics
     void showStatistics() const;
 
+    // show the count, min, max and average of each numeric field
+    void showSummary() const;
+
+    // screen the stocks by conditions on their numeric fields
+    void screenStocks() const;
+
+    // the stocks that meet the conditions of a screener, in the
+    // order they were added
+    // return the number of stocks found
+    int screenStocks(const Screener& screener, vector<Stock*>& found) const;
+
 };
 
 #endif // Stock_DB_H_
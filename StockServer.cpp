@@ -0,0 +1,360 @@
+// Implementation file for the StockServer class
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+using namespace std;
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#endif
+
+#include "StockDB.h"
+#include "BatchRunner.h"
+#include "StockServer.h"
+
+#ifdef __linux__
+
+// set by SIGINT and SIGTERM to stop the event loop
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+//**************************************************
+// make a file descriptor non-blocking
+//**************************************************
+static bool setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+#endif // __linux__
+
+//**************************************************
+// Constructor
+//**************************************************
+StockServer::StockServer(StockDB& db) : runner(db, cout)
+{
+    listenFd = -1;
+    epollFd = -1;
+    numRequests = 0;
+}
+
+//**************************************************
+// Destructor
+//**************************************************
+StockServer::~StockServer()
+{
+    close();
+}
+
+//**************************************************
+// report the statistics of the commands run
+//**************************************************
+void StockServer::showStats(ostream& os) const
+{
+    runner.showStats(os);
+}
+
+#ifdef __linux__
+
+//**************************************************
+// serve requests until SIGINT or SIGTERM
+// - input param: the path of the Unix domain socket
+// - return false if the socket cannot be opened
+//**************************************************
+bool StockServer::run(const string& path)
+{
+    if (!open(path)) {
+        close();
+        return false;
+    }
+
+    stopRequested = 0;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onStopSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    cout << "Serving on " << path << " (SIGINT or SIGTERM to stop)" << endl;
+
+    const int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    while (!stopRequested) {
+        int n = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cout << "Error waiting for events: " << strerror(errno) << endl;
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == NULL) {
+                acceptClients();
+                continue;
+            }
+            Connection* conn = static_cast<Connection*>(events[i].data.ptr);
+            bool open = true;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                open = readRequests(conn);
+            }
+            if (open && (events[i].events & EPOLLOUT)) {
+                open = writeResponses(conn);
+            }
+            if (open) {
+                updateEvents(conn);
+            }
+        }
+    }
+
+    cout << "Served " << numRequests << " requests" << endl;
+    close();
+    return true;
+}
+
+//**************************************************
+// create the listening socket and the epoll instance
+// An old socket file at the path is replaced
+// - input param: the path of the Unix domain socket
+// - return true if successful, otherwise, false
+//**************************************************
+bool StockServer::open(const string& path)
+{
+    sockaddr_un addr;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        cout << "Socket path is too long: \"" << path << "\"" << endl;
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || !setNonBlocking(listenFd)) {
+        cout << "Error creating the socket: " << strerror(errno) << endl;
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listenFd, SOMAXCONN) < 0) {
+        cout << "Error listening on \"" << path << "\": " << strerror(errno) << endl;
+        return false;
+    }
+    socketPath = path;
+
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        cout << "Error creating the epoll instance: " << strerror(errno) << endl;
+        return false;
+    }
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;   // the listening socket
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) < 0) {
+        cout << "Error adding the socket to epoll: " << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+//**************************************************
+// close all the connections and the sockets
+//**************************************************
+void StockServer::close()
+{
+    while (!connections.empty()) {
+        closeClient(connections.begin()->second);
+    }
+    if (epollFd >= 0) {
+        ::close(epollFd);
+        epollFd = -1;
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+        socketPath.clear();
+    }
+}
+
+//**************************************************
+// accept the pending connections
+//**************************************************
+void StockServer::acceptClients()
+{
+    while (true) {
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                cout << "Error accepting a connection: " << strerror(errno) << endl;
+            }
+            return;
+        }
+        if (!setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+
+        Connection* conn = new Connection;
+        conn->fd = fd;
+        conn->outPos = 0;
+        conn->numRequests = 0;
+        conn->events = EPOLLIN;
+
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = conn;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            ::close(fd);
+            delete conn;
+            continue;
+        }
+        connections[fd] = conn;
+    }
+}
+
+//**************************************************
+// read the available bytes of a connection and run the
+// whole requests in them, in order
+// The responses are sent right away if the socket takes them
+// - input param: the connection
+// - return false if the connection is closed
+//**************************************************
+bool StockServer::readRequests(Connection* conn)
+{
+    char buf[READ_SIZE];
+    ssize_t n = read(conn->fd, buf, sizeof(buf));
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return true;
+    }
+    if (n <= 0) {
+        closeClient(conn);
+        return false;
+    }
+    conn->in.append(buf, n);
+
+    // run the whole lines, keep a partial last line
+    size_t start = 0;
+    size_t end;
+    string line;
+    while ((end = conn->in.find('\n', start)) != string::npos) {
+        line.assign(conn->in, start, end - start);
+        start = end + 1;
+        conn->numRequests++;
+        numRequests++;
+        if (!line.empty() && line[line.size() - 1] == '\r') {
+            line.erase(line.size() - 1);
+        }
+        runner.runCommand(line, conn->numRequests, conn->out);
+    }
+    conn->in.erase(0, start);
+
+    // a request that never ends, the responses to the
+    // whole requests before it are sent if the socket takes them
+    if (conn->in.size() > MAX_LINE) {
+        cout << "Closing a connection with a request longer than "
+             << MAX_LINE << " bytes" << endl;
+        if (writeResponses(conn)) {
+            closeClient(conn);
+        }
+        return false;
+    }
+
+    return writeResponses(conn);
+}
+
+//**************************************************
+// send as much of the pending responses as the socket takes
+// - input param: the connection
+// - return false if the connection is closed
+//**************************************************
+bool StockServer::writeResponses(Connection* conn)
+{
+    while (conn->outPos < conn->out.size()) {
+        ssize_t n = write(conn->fd, conn->out.data() + conn->outPos,
+                          conn->out.size() - conn->outPos);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            closeClient(conn);
+            return false;
+        }
+        conn->outPos += n;
+    }
+    if (conn->outPos == conn->out.size()) {
+        conn->out.clear();
+        conn->outPos = 0;
+    }
+    return true;
+}
+
+//**************************************************
+// wait for EPOLLOUT while there are responses to send, and
+// stop reading while too many of them are pending
+//**************************************************
+void StockServer::updateEvents(Connection* conn)
+{
+    size_t pending = conn->out.size() - conn->outPos;
+    unsigned events = 0;
+    if (pending < MAX_PENDING) {
+        events |= EPOLLIN;
+    }
+    if (pending > 0) {
+        events |= EPOLLOUT;
+    }
+    if (events == conn->events) {
+        return;
+    }
+    epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = conn;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, conn->fd, &ev);
+    conn->events = events;
+}
+
+//**************************************************
+// close a connection and free it
+//**************************************************
+void StockServer::closeClient(Connection* conn)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+    ::close(conn->fd);
+    connections.erase(conn->fd);
+    delete conn;
+}
+
+#else
+
+//**************************************************
+// the server needs epoll
+//**************************************************
+bool StockServer::run(const string& path)
+{
+    cout << "The server mode is only available on Linux" << endl;
+    return false;
+}
+
+void StockServer::close()
+{
+}
+
+#endif // __linux__
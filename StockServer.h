@@ -0,0 +1,100 @@
+// Specification file for the StockServer class
+// StockServer serves one loaded StockDB to other processes over a
+// Unix domain socket,
+//   stockdb stocksDB.txt --serve /tmp/stockdb.sock
+// The protocol is the script protocol of BatchRunner: a request is one
+// command line ending with a newline, and the response is
+// "OK command N" followed by N stock lines, or "ERR command message".
+// A client may pipeline requests, i.e. send many of them without
+// waiting, and gets the responses in the same order.
+// The server is one thread with an epoll event loop over non-blocking
+// sockets, so the commands run one at a time and the DB needs no
+// locks. A connection whose responses are not read stops being read
+// until they are sent, and one that sends a line longer than MAX_LINE
+// is closed. SIGINT or SIGTERM stops the server, which then
+// reports the statistics of the commands it ran.
+// The server needs epoll, so it is only available on Linux.
+
+#ifndef STOCK_SERVER_H_
+#define STOCK_SERVER_H_
+
+#include <string>
+#include <unordered_map>
+#include "BatchRunner.h"
+using std::string;
+using std::unordered_map;
+
+class StockDB;
+
+class StockServer
+{
+private:
+    // the buffers of a client connection
+    struct Connection
+    {
+        int fd;
+        string in;          // bytes received, not yet a whole request
+        string out;         // responses not yet sent
+        size_t outPos;      // bytes of out already sent
+        int numRequests;    // requests received on the connection
+        unsigned events;    // the epoll events it waits for
+    };
+
+    // read this many bytes at a time
+    static const size_t READ_SIZE = 64 * 1024;
+
+    // stop reading a connection with this many bytes of responses to send
+    static const size_t MAX_PENDING = 4 * 1024 * 1024;
+
+    // close a connection whose partial request grows over this size
+    static const size_t MAX_LINE = 16 * READ_SIZE;
+
+    BatchRunner runner;
+    string socketPath;
+    int listenFd;
+    int epollFd;
+    unordered_map<int, Connection*> connections;
+    long long numRequests;
+
+public:
+    // constructor and destructor
+    StockServer(StockDB& db);
+    ~StockServer();
+
+    // listen on a Unix domain socket and serve requests until
+    // SIGINT or SIGTERM, return false if the socket cannot be opened
+    bool run(const string& path);
+
+    // report the statistics of the commands run to os
+    void showStats(ostream& os) const;
+
+private:
+    // create the listening socket and the epoll instance
+    bool open(const string& path);
+
+    // close all the connections and the sockets
+    void close();
+
+    // accept the pending connections
+    void acceptClients();
+
+    // read requests from a connection and run them
+    // return false if the connection is closed
+    bool readRequests(Connection* conn);
+
+    // send the pending responses of a connection
+    // return false if the connection is closed
+    bool writeResponses(Connection* conn);
+
+    // update the events a connection waits for
+    void updateEvents(Connection* conn);
+
+    // close a connection
+    void closeClient(Connection* conn);
+
+    // not copyable
+    StockServer(const StockServer&);
+    StockServer& operator=(const StockServer&);
+};
+
+#endif // STOCK_SERVER_H_
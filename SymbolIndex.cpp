@@ -0,0 +1,341 @@
+// Implementation file for the SymbolIndex class
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+using namespace std;
+
+#include "Stock.h"
+#include "SymbolIndex.h"
+
+//**************************************************
+// order two stocks of a group by date, then by unique key
+// for stocks without a valid date
+//**************************************************
+static bool lessDated(const DatedStock& s1, const DatedStock& s2)
+{
+    if (s1.days != s2.days) {
+        return s1.days < s2.days;
+    }
+    return *s1.stock < *s2.stock;
+}
+
+//**************************************************
+// order a stock before a date
+//**************************************************
+static bool beforeDay(const DatedStock& s, int days)
+{
+    return s.days < days;
+}
+
+//**************************************************
+// order a date before a stock
+//**************************************************
+static bool beforeStock(int days, const DatedStock& s)
+{
+    return days < s.days;
+}
+
+//**************************************************
+// Constructor
+// - input param: the number of stocks the indicators
+//                are taken over
+//**************************************************
+SymbolIndex::SymbolIndex(int period) : tree(compareGroups)
+{
+    count = 0;
+    this->period = period > 0 ? period : DEF_PERIOD;
+    alpha = 2.0 / (this->period + 1);
+}
+
+//**************************************************
+// Destructor
+// deletes the groups, but not the stocks
+//**************************************************
+SymbolIndex::~SymbolIndex()
+{
+    tree.postOrder([](SymbolGroup& group) {
+        delete &group;
+    });
+}
+
+//**************************************************
+// compare the symbols of two groups
+//**************************************************
+int SymbolIndex::compareGroups(const SymbolGroup& g1, const SymbolGroup& g2)
+{
+    return g1.symbol.compare(g2.symbol);
+}
+
+//**************************************************
+// compare the symbol of a group with a symbol
+//**************************************************
+int SymbolIndex::compareSymbol(const SymbolGroup& group, const string_view& symbol)
+{
+    return string_view(group.symbol).compare(symbol);
+}
+
+//**************************************************
+// find the group of a symbol
+// - input param: the symbol
+// - return the group, NULL if there is no such symbol
+//**************************************************
+SymbolGroup* SymbolIndex::findGroup(string_view symbol) const
+{
+    SymbolGroup* group = NULL;
+    if (!tree.find(symbol, compareSymbol, group)) {
+        return NULL;
+    }
+    return group;
+}
+
+//**************************************************
+// insert a stock into the group of its symbol
+// A new group is created for the first stock of a symbol
+// Stocks usually arrive in date order, so the insert
+// position is usually the end of the vector
+// - input param: the pointer to the stock to insert
+// - return true
+//**************************************************
+bool SymbolIndex::insert(Stock* dataIn)
+{
+    SymbolGroup* group = findGroup(dataIn->getSymbol());
+    if (!group) {
+        group = new SymbolGroup;
+        group->symbol = dataIn->getSymbol();
+        group->numUndated = 0;
+        group->window = WindowSums();
+        group->numAppends = 0;
+        tree.insert(group);
+    }
+
+    DatedStock entry = {dataIn->getDays(), dataIn->getVolume(), dataIn, dataIn->getPrice(), 0};
+    vector<DatedStock>& stocks = group->stocks;
+    count++;
+    if (entry.days == INT_MIN) {
+        // not in the indicators
+        stocks.insert(upper_bound(stocks.begin(), stocks.end(), entry, lessDated), entry);
+        group->numUndated++;
+        return true;
+    }
+
+    if (stocks.empty() || lessDated(stocks.back(), entry)) {
+        // the next stock of the symbol
+        stocks.push_back(entry);
+        updateEMA(*group, static_cast<int>(stocks.size()) - 1);
+        slideWindow(*group);
+        return true;
+    }
+
+    // a stock before the last date changes the EMA from it on,
+    // and the window if it is in the window
+    int pos = static_cast<int>(upper_bound(stocks.begin(), stocks.end(), entry, lessDated) -
+                               stocks.begin());
+    stocks.insert(stocks.begin() + pos, entry);
+    updateEMA(*group, pos);
+    int last = static_cast<int>(stocks.size()) - 1;
+    if (pos > last - period) {
+        sumWindow(*group, last, group->window);
+        group->numAppends = 0;
+    }
+
+    return true;
+}
+
+//**************************************************
+// remove a stock from the group of its symbol
+// The group is removed with its last stock
+// - input param: the stock with the symbol and date to remove
+// - return true if found, otherwise, false
+//   return the removed stock via output parameter
+//**************************************************
+bool SymbolIndex::remove(const Stock& key, Stock*& dataOut)
+{
+    SymbolGroup* group = findGroup(key.getSymbol());
+    if (!group) {
+        return false;
+    }
+
+    DatedStock entry = {key.getDays(), 0, const_cast<Stock*>(&key), 0, 0};
+    vector<DatedStock>& stocks = group->stocks;
+    vector<DatedStock>::iterator it = lower_bound(stocks.begin(), stocks.end(), entry, lessDated);
+    if (it == stocks.end() || !(*it->stock == key)) {
+        return false;
+    }
+    dataOut = it->stock;
+    int pos = static_cast<int>(it - stocks.begin());
+    stocks.erase(it);
+    count--;
+
+    if (stocks.empty()) {
+        SymbolGroup* g = NULL;
+        tree.remove(*group, g);
+        delete g;
+        return true;
+    }
+
+    if (key.getDays() == INT_MIN) {
+        group->numUndated--;
+        return true;
+    }
+
+    // the EMA changes from the next stock on, and the window
+    // if the stock was in it, the last period stocks before
+    updateEMA(*group, pos);
+    int last = static_cast<int>(stocks.size()) - 1;
+    if (pos > last + 1 - period) {
+        sumWindow(*group, last, group->window);
+        group->numAppends = 0;
+    }
+
+    return true;
+}
+
+//**************************************************
+// find the stocks of a symbol in a date range
+// - input params: the symbol, the first and last dates as
+//                 days since 01/01/1970, and the vector
+//                 to append the stocks found to
+// - return the number of stocks found
+//**************************************************
+int SymbolIndex::rangeSearch(string_view symbol, int fromDays, int toDays,
+                             vector<Stock*>& found) const
+{
+    SymbolGroup* group = findGroup(symbol);
+    if (!group || fromDays > toDays) {
+        return 0;
+    }
+
+    // stocks with unparsed dates (INT_MIN) are never in range
+    if (fromDays == INT_MIN) {
+        fromDays++;
+    }
+
+    const vector<DatedStock>& stocks = group->stocks;
+    vector<DatedStock>::const_iterator it = lower_bound(stocks.begin(), stocks.end(), fromDays, beforeDay);
+    int n = 0;
+    for (; it != stocks.end() && it->days <= toDays; ++it) {
+        found.push_back(it->stock);
+        n++;
+    }
+
+    return n;
+}
+
+//**************************************************
+// sum the window of the dated stocks of a group that ends
+// at a stock: the stock and the period - 1 stocks before it
+// - input params: the group, the index of the last stock of
+//                 the window, and the sums to fill
+//**************************************************
+void SymbolIndex::sumWindow(const SymbolGroup& group, int last, WindowSums& sums) const
+{
+    sums = WindowSums();
+    int first = max(group.numUndated, last - period + 1);
+    for (int i = first; i <= last; i++) {
+        double price = group.stocks[i].price;
+        double volume = group.stocks[i].volume;
+        sums.count++;
+        sums.price += price;
+        sums.priceSq += price * price;
+        sums.priceVolume += price * volume;
+        sums.volume += volume;
+    }
+}
+
+//**************************************************
+// add the last stock of a group to its window, and take
+// out the stock that leaves the window, in O(1)
+// The sums are summed again every period stocks, so the
+// rounding errors of the subtractions do not add up
+// - input param: the group
+//**************************************************
+void SymbolIndex::slideWindow(SymbolGroup& group)
+{
+    int last = static_cast<int>(group.stocks.size()) - 1;
+    if (++group.numAppends >= period) {
+        sumWindow(group, last, group.window);
+        group.numAppends = 0;
+        return;
+    }
+
+    WindowSums& sums = group.window;
+    double price = group.stocks[last].price;
+    double volume = group.stocks[last].volume;
+    sums.count++;
+    sums.price += price;
+    sums.priceSq += price * price;
+    sums.priceVolume += price * volume;
+    sums.volume += volume;
+
+    if (sums.count > period) {
+        price = group.stocks[last - period].price;
+        volume = group.stocks[last - period].volume;
+        sums.count--;
+        sums.price -= price;
+        sums.priceSq -= price * price;
+        sums.priceVolume -= price * volume;
+        sums.volume -= volume;
+    }
+}
+
+//**************************************************
+// recompute the EMA of the dated stocks of a group from a stock
+// to the last one; the first dated stock starts the EMA at its price
+// - input params: the group, and the index of the first stock
+//**************************************************
+void SymbolIndex::updateEMA(SymbolGroup& group, int first) const
+{
+    vector<DatedStock>& stocks = group.stocks;
+    int n = static_cast<int>(stocks.size());
+    for (int i = max(first, group.numUndated); i < n; i++) {
+        double price = stocks[i].price;
+        stocks[i].ema = (i == group.numUndated) ? price :
+                        alpha * price + (1 - alpha) * stocks[i - 1].ema;
+    }
+}
+
+//**************************************************
+// find the indicators of a symbol at a date
+// - input params: the symbol, the date as days since 01/01/1970
+//                 (INT_MAX for the last stock), and the
+//                 indicators to fill
+// - return false if the symbol has no dated stock on or before
+//   the date, otherwise, true and the indicators at the last
+//   stock on or before the date via output parameter
+//**************************************************
+bool SymbolIndex::getIndicators(string_view symbol, int days, Indicators& out) const
+{
+    SymbolGroup* group = findGroup(symbol);
+    if (!group || days == INT_MIN) {
+        return false;
+    }
+
+    const vector<DatedStock>& stocks = group->stocks;
+    int last = static_cast<int>(upper_bound(stocks.begin(), stocks.end(), days, beforeStock) -
+                                stocks.begin()) - 1;
+    if (last < group->numUndated) {
+        return false;
+    }
+
+    WindowSums sums;
+    if (last == static_cast<int>(stocks.size()) - 1) {
+        sums = group->window;
+    }
+    else {
+        sumWindow(*group, last, sums);
+    }
+
+    out.stock = stocks[last].stock;
+    out.count = sums.count;
+    out.sma = sums.price / sums.count;
+    out.ema = stocks[last].ema;
+    out.vwap = sums.volume > 0 ? sums.priceVolume / sums.volume : out.sma;
+    out.stddev = sqrt(max(0.0, sums.priceSq / sums.count - out.sma * out.sma));
+    out.lower = out.sma - BOLLINGER_WIDTH * out.stddev;
+    out.upper = out.sma + BOLLINGER_WIDTH * out.stddev;
+
+    return true;
+}
@@ -0,0 +1,157 @@
+// Specification file for the SymbolIndex class
+// SymbolIndex is the time-series index of the stock database.
+// It is an AVL tree with one node per stock symbol, and each node
+// keeps the stocks of that symbol in a vector sorted by date, so
+// the stocks of a symbol between two dates are found with one tree
+// lookup and one binary search: O(log n + k) for k stocks.
+// The dates are the days parsed by the Stock objects. Stocks with
+// a date that cannot be parsed are kept first in their symbol and
+// are never returned by range queries.
+// Each symbol also keeps the state of its price indicators over the
+// last PERIOD stocks: the sums of the price, the squared price, the
+// price times the volume and the volume, for the simple moving
+// average, the Bollinger bands and the VWAP, and the exponential
+// moving average at each stock. A stock added after the last date
+// updates them in O(1). A stock added or removed before the last
+// date recomputes the EMA from that stock on, and the sums only if
+// it is one of the last PERIOD stocks. The indicators at an earlier
+// date are summed from the PERIOD stocks up to it.
+// SymbolIndex only stores the pointers to the Stock objects
+
+#ifndef SYMBOL_INDEX_H_
+#define SYMBOL_INDEX_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+using std::string;
+using std::string_view;
+using std::vector;
+
+#include "AVLTree.h"
+
+class Stock;
+
+// a stock and its date as days since 01/01/1970
+// with copies of the fields the indicators are taken over, so
+// they are read from the vector of the symbol, not from the stocks
+struct DatedStock
+{
+    int days;
+    int volume;
+    Stock* stock;
+    double price;
+    double ema;         // EMA of the price up to this stock
+};
+
+// the sums of the fields of the stocks in a window
+struct WindowSums
+{
+    int count;
+    double price;
+    double priceSq;
+    double priceVolume;
+    double volume;
+};
+
+// the indicators of a symbol at one of its stocks
+struct Indicators
+{
+    Stock* stock;       // the last stock of the window
+    int count;          // stocks in the window, up to the period
+    double sma;         // simple moving average of the price
+    double ema;         // exponential moving average of the price
+    double vwap;        // volume-weighted average price
+    double stddev;      // standard deviation of the price
+    double lower;       // Bollinger bands, the SMA -/+ 2 stddev
+    double upper;
+};
+
+// the stocks of one symbol, sorted by date, and the
+// state of their indicators
+struct SymbolGroup
+{
+    string symbol;
+    vector<DatedStock> stocks;
+    int numUndated;     // stocks with an unparsed date, kept first
+    WindowSums window;  // sums of the last PERIOD dated stocks
+    int numAppends;     // stocks added at the end since the sums were summed
+
+    // groups are ordered and matched by symbol
+    bool operator < (const SymbolGroup& obj) const {return symbol < obj.symbol;}
+    bool operator > (const SymbolGroup& obj) const {return symbol > obj.symbol;}
+    bool operator == (const SymbolGroup& obj) const {return symbol == obj.symbol;}
+};
+
+class SymbolIndex
+{
+public:
+    // the default number of stocks the indicators are taken over
+    static const int DEF_PERIOD = 20;
+
+    // the width of the Bollinger bands, in standard deviations
+    static const int BOLLINGER_WIDTH = 2;
+
+private:
+    AVLTree<SymbolGroup> tree;   // one node per symbol
+    int count;                   // number of stocks
+    int period;                  // stocks in the indicator window
+    double alpha;                // EMA weight of a new price, 2 / (period + 1)
+
+public:
+    // constructor and destructor, the indicators are
+    // taken over the last period stocks
+    SymbolIndex(int period = DEF_PERIOD);
+    ~SymbolIndex();
+
+    // getters
+    int getCount() const {return count;}
+    int getNumSymbols() const {return tree.getCount();}
+    int getPeriod() const {return period;}
+    bool isEmpty() const {return count == 0;}
+
+    // insert a stock into the group of its symbol
+    bool insert(Stock* dataIn);
+
+    // remove the stock with the same symbol and date as key
+    // return the removed stock via output parameter
+    bool remove(const Stock& key, Stock*& dataOut);
+
+    // append the stocks of a symbol from fromDays to toDays
+    // (days since 01/01/1970, both included) in date order
+    // return the number of stocks found
+    int rangeSearch(string_view symbol, int fromDays, int toDays,
+                    vector<Stock*>& found) const;
+
+    // the indicators of a symbol at its last stock on or before
+    // days (days since 01/01/1970, INT_MAX for its last stock)
+    // O(log n) at the last stock, O(log n + period) before it
+    // return false if the symbol has no stock on or before days
+    bool getIndicators(string_view symbol, int days, Indicators& out) const;
+
+private:
+    // compare the symbols of two groups
+    static int compareGroups(const SymbolGroup& g1, const SymbolGroup& g2);
+
+    // compare the symbol of a group with a symbol
+    static int compareSymbol(const SymbolGroup& group, const string_view& symbol);
+
+    // find the group of a symbol, NULL if none
+    SymbolGroup* findGroup(string_view symbol) const;
+
+    // sum the window of the dated stocks of a group up to stock last
+    void sumWindow(const SymbolGroup& group, int last, WindowSums& sums) const;
+
+    // add a stock at the end of the window of a group, and drop
+    // the stock that leaves it
+    void slideWindow(SymbolGroup& group);
+
+    // recompute the EMA of the dated stocks of a group from stock first
+    void updateEMA(SymbolGroup& group, int first) const;
+
+    // not copyable
+    SymbolIndex(const SymbolIndex&);
+    SymbolIndex& operator=(const SymbolIndex&);
+};
+
+#endif // SYMBOL_INDEX_H_
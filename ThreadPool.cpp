@@ -0,0 +1,103 @@
+// Implementation file for the ThreadPool class
+
+#include "ThreadPool.h"
+using namespace std;
+
+//**************************************************
+// Constructor
+// start the worker threads
+//**************************************************
+ThreadPool::ThreadPool(int numThreads)
+{
+    pending = 0;
+    stopping = false;
+
+    if (numThreads <= 0) {
+        numThreads = hardwareThreads();
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers.push_back(thread(&ThreadPool::run, this));
+    }
+}
+
+//**************************************************
+// Destructor
+// finish the queued tasks and join the worker threads
+//**************************************************
+ThreadPool::~ThreadPool()
+{
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+//**************************************************
+// queue a task to run on a worker thread
+// - input param: the task to run
+//**************************************************
+void ThreadPool::submit(const function<void()>& task)
+{
+    {
+        unique_lock<mutex> guard(lock);
+        tasks.push(task);
+        pending++;
+    }
+    taskReady.notify_one();
+}
+
+//**************************************************
+// block until all the submitted tasks are done
+//**************************************************
+void ThreadPool::wait()
+{
+    unique_lock<mutex> guard(lock);
+    while (pending > 0) {
+        allDone.wait(guard);
+    }
+}
+
+//**************************************************
+// return the number of hardware cores, at least 1
+//**************************************************
+int ThreadPool::hardwareThreads()
+{
+    int n = static_cast<int>(thread::hardware_concurrency());
+    return n > 0 ? n : 1;
+}
+
+//**************************************************
+// worker thread loop: run tasks until the pool is destroyed
+//**************************************************
+void ThreadPool::run()
+{
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(lock);
+            while (!stopping && tasks.empty()) {
+                taskReady.wait(guard);
+            }
+            if (tasks.empty()) {
+                // stopping and nothing left to run
+                return;
+            }
+            task = tasks.front();
+            tasks.pop();
+        }
+
+        task();
+
+        {
+            unique_lock<mutex> guard(lock);
+            pending--;
+            if (pending == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// Specification file for the ThreadPool class
+// ThreadPool keeps a fixed number of worker threads which
+// run the submitted tasks in FIFO order. The caller can wait
+// until all the submitted tasks are done.
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;           // worker threads
+    std::queue<std::function<void()> > tasks;   // tasks waiting to run
+    std::mutex lock;                            // protects tasks and counters
+    std::condition_variable taskReady;          // signaled when a task is queued
+    std::condition_variable allDone;            // signaled when pending drops to 0
+    int pending;                                // tasks queued or running
+    bool stopping;                              // set by the destructor
+
+public:
+    // constructor and destructor
+    // numThreads <= 0 uses one thread per hardware core
+    ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    // getters
+    int getSize() const {return static_cast<int>(workers.size());}
+
+    // queue a task to run on a worker thread
+    void submit(const std::function<void()>& task);
+
+    // block until all the submitted tasks are done
+    void wait();
+
+    // the number of hardware cores, at least 1
+    static int hardwareThreads();
+
+private:
+    // worker thread loop
+    void run();
+
+    // not copyable
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif // THREAD_POOL_H_
@@ -0,0 +1,249 @@
+// Implementation file for the TopStocks class
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+using namespace std;
+
+#include "Stock.h"
+#include "TopStocks.h"
+
+//**************************************************
+// the gainers order: by change, largest first,
+// then by symbol + date
+//**************************************************
+static bool moreChange(const Stock* s1, const Stock* s2)
+{
+    if (s1->getChange() != s2->getChange()) {
+        return s1->getChange() > s2->getChange();
+    }
+    return *s1 < *s2;
+}
+
+//**************************************************
+// the losers order: by change, smallest first,
+// then by symbol + date
+//**************************************************
+static bool lessChange(const Stock* s1, const Stock* s2)
+{
+    if (s1->getChange() != s2->getChange()) {
+        return s1->getChange() < s2->getChange();
+    }
+    return *s1 < *s2;
+}
+
+//**************************************************
+// the volume order: by volume, largest first,
+// then by symbol + date
+//**************************************************
+static bool moreVolume(const Stock* s1, const Stock* s2)
+{
+    if (s1->getVolume() != s2->getVolume()) {
+        return s1->getVolume() > s2->getVolume();
+    }
+    return *s1 < *s2;
+}
+
+// the order of each ranking, indexed by TopStocks::Ranking
+static bool (* const ranksBefore[TopStocks::NUM_RANKINGS])(const Stock*, const Stock*) = {
+    moreChange, lessChange, moreVolume
+};
+
+//**************************************************
+// Constructor
+// - input param: the number of stocks kept per ranking
+//**************************************************
+TopStocks::TopStocks(int k) : tree(compareGroups)
+{
+    this->k = k > 0 ? k : DEF_K;
+    count = 0;
+}
+
+//**************************************************
+// Destructor
+// deletes the groups, but not the stocks
+//**************************************************
+TopStocks::~TopStocks()
+{
+    tree.postOrder([](DateGroup& group) {
+        delete &group;
+    });
+}
+
+//**************************************************
+// the name of a ranking, as written in the scripts
+//**************************************************
+const char* TopStocks::getRankingName(Ranking ranking)
+{
+    static const char* names[NUM_RANKINGS] = {"gainers", "losers", "volume"};
+    return names[ranking];
+}
+
+//**************************************************
+// compare the dates of two groups
+//**************************************************
+int TopStocks::compareGroups(const DateGroup& g1, const DateGroup& g2)
+{
+    return g1.days < g2.days ? -1 : (g1.days > g2.days ? 1 : 0);
+}
+
+//**************************************************
+// compare the date of a group with a date
+//**************************************************
+int TopStocks::compareDays(const DateGroup& group, const int& days)
+{
+    return group.days < days ? -1 : (group.days > days ? 1 : 0);
+}
+
+//**************************************************
+// find the group of a date
+// - input param: the date as days since 01/01/1970
+// - return the group, NULL if there is no stock of that date
+//**************************************************
+DateGroup* TopStocks::findGroup(int days) const
+{
+    DateGroup* group = NULL;
+    if (!tree.find(days, compareDays, group)) {
+        return NULL;
+    }
+    return group;
+}
+
+//**************************************************
+// add a stock to a ranking of its group if it ranks before
+// the last of the first K, or if there are fewer than K
+// The list is sorted, so this is one compare for most stocks
+// and O(K) for the others
+// - input params: the group, the ranking, and the stock
+//**************************************************
+void TopStocks::offer(DateGroup& group, int ranking, Stock* stk)
+{
+    vector<Stock*>& top = group.top[ranking];
+    bool (*before)(const Stock*, const Stock*) = ranksBefore[ranking];
+    if (static_cast<int>(top.size()) == k) {
+        if (!before(stk, top.back())) {
+            return;
+        }
+        top.pop_back();
+    }
+    top.insert(upper_bound(top.begin(), top.end(), stk, before), stk);
+}
+
+//**************************************************
+// insert a stock into the group of its date
+// A new group is created for the first stock of a date
+// - input param: the pointer to the stock to insert
+// - return false if the date of the stock cannot be parsed
+//**************************************************
+bool TopStocks::insert(Stock* dataIn)
+{
+    if (dataIn->getDays() == INT_MIN) {
+        return false;
+    }
+
+    DateGroup* group = findGroup(dataIn->getDays());
+    if (!group) {
+        group = new DateGroup;
+        group->days = dataIn->getDays();
+        tree.insert(group);
+    }
+
+    group->stocks.push_back(dataIn);
+    for (int r = 0; r < NUM_RANKINGS; r++) {
+        offer(*group, r, dataIn);
+    }
+    count++;
+
+    return true;
+}
+
+//**************************************************
+// remove a stock from the group of its date
+// The stock is swapped with the last stock of the group.
+// A ranking it was in takes the first of the other stocks
+// that rank after the rest of the list, so the list still
+// holds the first K stocks of the date.
+// The group is removed with its last stock
+// - input param: the pointer to the stock to remove
+// - return true if found, otherwise, false
+//**************************************************
+bool TopStocks::remove(Stock* dataIn)
+{
+    DateGroup* group = findGroup(dataIn->getDays());
+    if (!group) {
+        return false;
+    }
+
+    vector<Stock*>& stocks = group->stocks;
+    vector<Stock*>::iterator it = find(stocks.begin(), stocks.end(), dataIn);
+    if (it == stocks.end()) {
+        return false;
+    }
+    *it = stocks.back();
+    stocks.pop_back();
+    count--;
+
+    if (stocks.empty()) {
+        DateGroup* g = NULL;
+        tree.remove(*group, g);
+        delete g;
+        return true;
+    }
+
+    for (int r = 0; r < NUM_RANKINGS; r++) {
+        vector<Stock*>& top = group->top[r];
+        vector<Stock*>::iterator pos = find(top.begin(), top.end(), dataIn);
+        if (pos == top.end()) {
+            continue;
+        }
+        top.erase(pos);
+
+        // the list held all the stocks of the date
+        if (top.size() == stocks.size()) {
+            continue;
+        }
+
+        // the first stock that ranks after the list
+        bool (*before)(const Stock*, const Stock*) = ranksBefore[r];
+        const Stock* last = top.empty() ? NULL : top.back();
+        Stock* next = NULL;
+        for (size_t i = 0; i < stocks.size(); i++) {
+            if ((!last || before(last, stocks[i])) && (!next || before(stocks[i], next))) {
+                next = stocks[i];
+            }
+        }
+        top.push_back(next);
+    }
+
+    return true;
+}
+
+//**************************************************
+// find the first stocks of a ranking on a date
+// - input params: the ranking, the date as days since
+//                 01/01/1970, the number of stocks, and
+//                 the vector to append the stocks to
+// - return the number of stocks appended
+//**************************************************
+int TopStocks::getTop(Ranking ranking, int days, int n, vector<Stock*>& found) const
+{
+    DateGroup* group = findGroup(days);
+    if (!group || n <= 0) {
+        return 0;
+    }
+
+    const vector<Stock*>& top = group->top[ranking];
+    if (n <= k || top.size() == group->stocks.size()) {
+        n = min(n, static_cast<int>(top.size()));
+        found.insert(found.end(), top.begin(), top.begin() + n);
+        return n;
+    }
+
+    // more than the list holds
+    n = min(n, static_cast<int>(group->stocks.size()));
+    size_t first = found.size();
+    found.resize(first + n);
+    partial_sort_copy(group->stocks.begin(), group->stocks.end(),
+                      found.begin() + first, found.end(), ranksBefore[ranking]);
+    return n;
+}
@@ -0,0 +1,101 @@
+// Specification file for the TopStocks class
+// TopStocks keeps the top movers of each date: the K stocks with
+// the largest change (gainers), the K with the smallest change
+// (losers) and the K with the largest volume. It is an AVL tree
+// with one node per date, and each node keeps the stocks of that
+// date and one short sorted list per ranking, which an insert
+// updates in O(K). A query for up to K stocks copies the front of
+// a list, O(log dates + K), without looking at the other stocks.
+// Removing a stock that is in a list takes the next stock of the
+// ranking from the stocks of the date, O(stocks of the date), so
+// the lists always hold the first K stocks of the date.
+// Stocks with the same change or volume are ranked by symbol + date.
+// Stocks with a date that cannot be parsed are not kept.
+// TopStocks only stores the pointers to the Stock objects
+
+#ifndef TOP_STOCKS_H_
+#define TOP_STOCKS_H_
+
+#include <vector>
+using std::vector;
+
+#include "AVLTree.h"
+
+class Stock;
+
+// the stocks of one date and its rankings
+struct DateGroup
+{
+    // the number of rankings, see TopStocks::Ranking
+    static const int NUM_RANKINGS = 3;
+
+    int days;                            // days since 01/01/1970
+    vector<Stock*> stocks;               // in the order they were added
+    vector<Stock*> top[NUM_RANKINGS];    // the first K of each ranking
+
+    // groups are ordered and matched by date
+    bool operator < (const DateGroup& obj) const {return days < obj.days;}
+    bool operator > (const DateGroup& obj) const {return days > obj.days;}
+    bool operator == (const DateGroup& obj) const {return days == obj.days;}
+};
+
+class TopStocks
+{
+public:
+    // the rankings of the stocks of a date
+    enum Ranking {GAINERS, LOSERS, VOLUME, NUM_RANKINGS};
+
+    // the default number of stocks kept per ranking
+    static const int DEF_K = 20;
+
+private:
+    AVLTree<DateGroup> tree;     // one node per date
+    int k;                       // stocks kept per ranking
+    int count;                   // number of stocks
+
+public:
+    // constructor and destructor, k stocks are kept per ranking
+    TopStocks(int k = DEF_K);
+    ~TopStocks();
+
+    // getters
+    int getK() const {return k;}
+    int getCount() const {return count;}
+    int getNumDates() const {return tree.getCount();}
+
+    // insert a stock into the group of its date
+    // return false if its date cannot be parsed
+    bool insert(Stock* dataIn);
+
+    // remove a stock from the group of its date
+    // return false if it is not in the group
+    bool remove(Stock* dataIn);
+
+    // append the first n stocks of a ranking on a date (days since
+    // 01/01/1970), in ranking order; O(n) up to K, and a partial
+    // sort of the stocks of the date above K
+    // return the number of stocks appended
+    int getTop(Ranking ranking, int days, int n, vector<Stock*>& found) const;
+
+    // the name of a ranking
+    static const char* getRankingName(Ranking ranking);
+
+private:
+    // compare the dates of two groups
+    static int compareGroups(const DateGroup& g1, const DateGroup& g2);
+
+    // compare the date of a group with a date
+    static int compareDays(const DateGroup& group, const int& days);
+
+    // find the group of a date, NULL if none
+    DateGroup* findGroup(int days) const;
+
+    // add a stock to a ranking of its group if it is in the first K
+    void offer(DateGroup& group, int ranking, Stock* stk);
+
+    // not copyable
+    TopStocks(const TopStocks&);
+    TopStocks& operator=(const TopStocks&);
+};
+
+#endif // TOP_STOCKS_H_
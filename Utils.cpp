@@ -5,29 +5,97 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <charconv>
+#include <cstring>
+#include <cmath>
 using namespace std;
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#define fsync _commit
+#endif
+
 #include "Stock.h"
 #include "Utils.h"
 
+// the displays of many stocks are written in blocks of this size
+static const size_t DISPLAY_BLOCK_SIZE = 1 << 20;
+
+//**************************************************
+// append a number with a number of decimals, like fixed
+// and setprecision
+// - input params: the string to append to, the number,
+//                 and the number of decimals
+//**************************************************
+void appendFixed(string& out, double val, int precision)
+{
+    // the longest double in fixed notation is about 310 characters
+    char buf[320];
+    to_chars_result res = to_chars(buf, buf + sizeof(buf), val, chars_format::fixed, precision);
+    out.append(buf, res.ptr);
+}
+
+//**************************************************
+// append a column of the table display: the text left
+// justified in width characters, like left and setw,
+// with a blank on both sides
+// - input params: the string to append to, the text,
+//                 and the width of the column
+//**************************************************
+static void appendColumn(string& out, string_view text, size_t width)
+{
+    out += ' ';
+    out.append(text.data(), text.size());
+    if (text.size() < width) {
+        out.append(width - text.size(), ' ');
+    }
+    out += ' ';
+}
+
+//**************************************************
+// append a number column of the table display
+//**************************************************
+static void appendColumn(string& out, double val, size_t width)
+{
+    char buf[320];
+    to_chars_result res = to_chars(buf, buf + sizeof(buf), val, chars_format::fixed, 2);
+    appendColumn(out, string_view(buf, res.ptr - buf), width);
+}
+
 //**************************************************
 // horizontal display : all items on one line
 // - input param: stock object
 //**************************************************
 void hDisplay(Stock& item)
 {
+    string line;
+    appendDisplayLine(line, item);
     cout << fixed << setprecision(2);
-    cout << item.getCompanyName() << " ("
-        << item.getSymbol() << ") "
-        << item.getDate() << " "
-        << item.getPrice() << " "
-        << (item.getChange() > 0 ? "+" : "")
-        << item.getChange()
-        << " Day's Range "
-        << item.getLow() << "-" << item.getHigh()
-        << " 52-Week Range "
-        << item.getYearLow() << "-" << item.getYearHigh()
-        << " Volume " << item.getVolume() << endl;
+    cout.write(line.data(), line.size());
+}
+
+//**************************************************
+// horizontal display of stocks, one per line
+// The lines are formatted in a buffer that is written
+// to the stream in large blocks, without flushing
+// - input params: the stocks, and the stream to write to
+//**************************************************
+void hDisplay(const vector<Stock*>& stocks, ostream& os)
+{
+    string block;
+    block.reserve(DISPLAY_BLOCK_SIZE + 512);
+    for (size_t i = 0; i < stocks.size(); i++) {
+        appendDisplayLine(block, *stocks[i]);
+        if (block.size() >= DISPLAY_BLOCK_SIZE) {
+            os.write(block.data(), block.size());
+            block.clear();
+        }
+    }
+    os.write(block.data(), block.size());
 }
 
 //**************************************************
@@ -36,19 +104,81 @@ void hDisplay(Stock& item)
 //**************************************************
 void tDisplay(Stock& item)
 {
-    cout << left;
-    cout << " " << setw(6) << item.getSymbol() << " ";
-    cout << " " << setw(22) << item.getCompanyName() << " ";
-    cout << " " << setw(10) << item.getDate() << " ";
-    cout << fixed << setprecision(2);
-    cout << " " << setw(9) << item.getPrice() << " ";
-    cout << " " << setw(9) << item.getHigh() << " ";
-    cout << " " << setw(9) << item.getLow() << " ";
-    cout << " " << setw(9) << item.getChange() << " ";
-    cout << " " << setw(9) << item.getVolume() << " ";
-    cout << " " << setw(9) << item.getYearHigh() << " ";
-    cout << " " << setw(9) << item.getYearLow() << " ";
-    cout << endl;
+    string row;
+    appendTableRow(row, item);
+    cout.write(row.data(), row.size());
+}
+
+//**************************************************
+// append the header of the table display
+// - input param: the string to append to
+//**************************************************
+void appendTableHeader(string& out)
+{
+    appendColumn(out, "Symbol", 6);
+    appendColumn(out, "Company Name", 22);
+    appendColumn(out, "Date", 10);
+    appendColumn(out, "Price", 9);
+    appendColumn(out, "Day High", 9);
+    appendColumn(out, "Day Low", 9);
+    appendColumn(out, "Change", 9);
+    appendColumn(out, "Volume", 9);
+    appendColumn(out, "52wk High", 9);
+    appendColumn(out, "52wk Low", 9);
+    out += '\n';
+}
+
+//**************************************************
+// append a stock as a row of the table display
+// - input params: the string to append to, and the stock object
+//**************************************************
+void appendTableRow(string& out, const Stock& stk)
+{
+    char buf[16];
+    to_chars_result res = to_chars(buf, buf + sizeof(buf), stk.getVolume());
+
+    appendColumn(out, stk.getSymbol(), 6);
+    appendColumn(out, stk.getCompanyName(), 22);
+    appendColumn(out, stk.getDate(), 10);
+    appendColumn(out, stk.getPrice(), 9);
+    appendColumn(out, stk.getHigh(), 9);
+    appendColumn(out, stk.getLow(), 9);
+    appendColumn(out, stk.getChange(), 9);
+    appendColumn(out, string_view(buf, res.ptr - buf), 9);
+    appendColumn(out, stk.getYearHigh(), 9);
+    appendColumn(out, stk.getYearLow(), 9);
+    out += '\n';
+}
+
+//**************************************************
+// append a stock as a line of the horizontal display
+// - input params: the string to append to, and the stock object
+//**************************************************
+void appendDisplayLine(string& out, const Stock& stk)
+{
+    out += stk.getCompanyName();
+    out += " (";
+    out += stk.getSymbol();
+    out += ") ";
+    out += stk.getDate();
+    out += ' ';
+    appendFixed(out, stk.getPrice());
+    out += ' ';
+    if (stk.getChange() > 0) {
+        out += '+';
+    }
+    appendFixed(out, stk.getChange());
+    out += " Day's Range ";
+    appendFixed(out, stk.getLow());
+    out += '-';
+    appendFixed(out, stk.getHigh());
+    out += " 52-Week Range ";
+    appendFixed(out, stk.getYearLow());
+    out += '-';
+    appendFixed(out, stk.getYearHigh());
+    out += " Volume ";
+    appendNumber(out, stk.getVolume());
+    out += '\n';
 }
 
 //**************************************************
@@ -62,20 +192,6 @@ void iDisplay(Stock& item, int level)
     cout << level << "). " << item.getCompanyName() << endl;
 }
 
-//**************************************************
-// Hash function: takes the key and returns the index in the hash table
-// - input params: stock object
-//                 the size of the hash table
-//**************************************************
-int key_to_index(const Stock& key, int size)
-{
-    string k = key.getUniqueKey();
-    int sum = 0;
-    for (int i = 0; k[i]; i++)
-        sum += k[i];
-    return sum % size;
-};
-
 //**************************************************
 // compare two Stock objects
 // - compare the secondary key (company name) of Stock object
@@ -144,6 +260,236 @@ int nextPrime(int N)
     return prime;
 }
 
+//**************************************************
+// skip the blanks and an optional plus sign before a number
+// - input params: the character range [first, last)
+// - return the position of the first character of the number
+//**************************************************
+static const char* skipToNumber(const char* first, const char* last)
+{
+    while (first < last && (*first == ' ' || *first == '\t')) {
+        first++;
+    }
+    // from_chars does not accept a leading plus sign, e.g. +1.99
+    if (first + 1 < last && *first == '+' && first[1] != '-') {
+        first++;
+    }
+    return first;
+}
+
+//**************************************************
+// parse a floating point number in place
+// from_chars accepts nan, inf and infinity, which are rejected
+// like the stream extraction of the DB file did
+// - input params: the character range [first, last)
+// - return true if successful, otherwise, false
+//   return the number via output parameter and
+//   move first past the number
+//**************************************************
+bool parseNumber(const char*& first, const char* last, double& val)
+{
+    const char* p = skipToNumber(first, last);
+    from_chars_result res = from_chars(p, last, val);
+    if (res.ec != errc() || !isfinite(val)) {
+        return false;
+    }
+    first = res.ptr;
+    return true;
+}
+
+//**************************************************
+// parse an integer in place
+// - input params: the character range [first, last)
+// - return true if successful, otherwise, false
+//   return the number via output parameter and
+//   move first past the number
+//**************************************************
+bool parseNumber(const char*& first, const char* last, int& val)
+{
+    const char* p = skipToNumber(first, last);
+    from_chars_result res = from_chars(p, last, val);
+    if (res.ec != errc()) {
+        return false;
+    }
+    first = res.ptr;
+    return true;
+}
+
+//**************************************************
+// parse a date in the mm/dd/year format
+// The month and day can have one or two digits, and the year
+// is a full year. Dates that do not exist, e.g. 2/30/2021,
+// are rejected.
+// - input param: the date string
+// - return true if successful, otherwise, false
+//   return the number of days since 01/01/1970 via
+//   output parameter
+//**************************************************
+bool parseDate(string_view date, int& days)
+{
+    const char* first = date.data();
+    const char* last = first + date.size();
+    int month, day, year;
+
+    from_chars_result res = from_chars(first, last, month);
+    if (res.ec != errc() || res.ptr == last || *res.ptr != '/') {
+        return false;
+    }
+    res = from_chars(res.ptr + 1, last, day);
+    if (res.ec != errc() || res.ptr == last || *res.ptr != '/') {
+        return false;
+    }
+    res = from_chars(res.ptr + 1, last, year);
+    if (res.ec != errc() || res.ptr != last) {
+        return false;
+    }
+
+    static const int DAYS_IN_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (year < 1 || year > 9999 || month < 1 || month > 12 || day < 1 ||
+        day > DAYS_IN_MONTH[month - 1] + (month == 2 && leap ? 1 : 0)) {
+        return false;
+    }
+
+    // days from the civil date (proleptic Gregorian calendar),
+    // counting years from March so the leap day is last
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yoe = y - era * 400;                                          // [0, 399]
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // [0, 365]
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                  // [0, 146096]
+    days = era * 146097 + doe - 719468;
+
+    return true;
+}
+
+//**************************************************
+// pack a symbol and a date into a 64-bit key
+// The characters are coded in ASCII order from 1, and 0 pads
+// short symbols, so the keys order like the symbol strings.
+// - input params: the symbol, and the date as days since 01/01/1970
+// - return the key, or 0 if the symbol is empty, longer than
+//   8 characters or has other characters, or the date is
+//   before 01/01/1900 or after 06/06/2079
+//**************************************************
+uint64_t packKey(string_view symbol, int days)
+{
+    static const char SYMBOL_CHARS[] = "&-./0123456789=ABCDEFGHIJKLMNOPQRSTUVWXYZ^_";
+    const int MAX_SYMBOL_LEN = 8;
+    const int DAYS_1900 = -25567;   // 01/01/1900 as days since 01/01/1970
+
+    if (symbol.empty() || symbol.size() > MAX_SYMBOL_LEN) {
+        return 0;
+    }
+    long long day = static_cast<long long>(days) - DAYS_1900;
+    if (day < 0 || day > 0xffff) {
+        return 0;
+    }
+
+    uint64_t key = 0;
+    for (int i = 0; i < MAX_SYMBOL_LEN; i++) {
+        uint64_t code = 0;
+        if (i < static_cast<int>(symbol.size())) {
+            const char* p = symbol[i] ? strchr(SYMBOL_CHARS, symbol[i]) : NULL;
+            if (!p) {
+                return 0;
+            }
+            code = p - SYMBOL_CHARS + 1;
+        }
+        key = (key << 6) | code;
+    }
+
+    return (key << 16) | static_cast<uint64_t>(day);
+}
+
+//**************************************************
+// append a floating point number to a string
+// in the shortest form that reads back exactly
+// - input params: the string to append to, and the number
+//**************************************************
+void appendNumber(string& out, double val)
+{
+    char buf[32];
+    to_chars_result res = to_chars(buf, buf + sizeof(buf), val);
+    out.append(buf, res.ptr);
+}
+
+//**************************************************
+// append an integer to a string
+// - input params: the string to append to, and the number
+//**************************************************
+void appendNumber(string& out, int val)
+{
+    char buf[16];
+    to_chars_result res = to_chars(buf, buf + sizeof(buf), val);
+    out.append(buf, res.ptr);
+}
+
+//**************************************************
+// append a stock to a string in the DB file line format:
+// symbol company; date; price high low change volume yearHigh yearLow
+// - input params: the string to append to, and the stock object
+//**************************************************
+void appendStockLine(string& out, const Stock& stk)
+{
+    out += stk.getSymbol();
+    out += ' ';
+    out += stk.getCompanyName();
+    out += "; ";
+    out += stk.getDate();
+    out += "; ";
+    appendNumber(out, stk.getPrice());
+    out += ' ';
+    appendNumber(out, stk.getHigh());
+    out += ' ';
+    appendNumber(out, stk.getLow());
+    out += ' ';
+    appendNumber(out, stk.getChange());
+    out += ' ';
+    appendNumber(out, stk.getVolume());
+    out += ' ';
+    appendNumber(out, stk.getYearHigh());
+    out += ' ';
+    appendNumber(out, stk.getYearLow());
+}
+
+//**************************************************
+// checksum of a block of memory, 8 bytes at a time
+// - input params: the block, its size, and the checksum so far
+// - return the updated checksum
+//**************************************************
+uint64_t checksum(const char* data, size_t size, uint64_t h)
+{
+    const uint64_t PRIME = 0x100000001b3ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ w) * PRIME;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * PRIME;
+    }
+    return h;
+}
+
+//**************************************************
+// flush a file to the disk
+// - input param: the filename
+// - return true if successful, otherwise, false
+//**************************************************
+bool syncFile(const string& filename)
+{
+    int fd = open(filename.c_str(), O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
 //**************************************************
 // Trim a string in C++  Remove leading and trailing spaces
 //**************************************************
@@ -4,6 +4,11 @@
 #define UTILS_H_
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
 
 // Forward Declaration
 class Stock; 
@@ -11,16 +16,25 @@ class Stock;
 // horizontal display of a stock
 void hDisplay(Stock&);
 
+// horizontal display of stocks to a stream,
+// formatted in a buffer and written in large blocks
+void hDisplay(const vector<Stock*>& stocks, ostream& os);
+
 // table format display of a stock
 void tDisplay(Stock&);
 
+// append the header of the table display, or a stock as a row
+// of the table display, with the newline; the numbers are
+// formatted with to_chars, so no stream is involved
+void appendTableHeader(string& out);
+void appendTableRow(string& out, const Stock& stk);
+
+// append a stock as a line of the horizontal display, with the newline
+void appendDisplayLine(string& out, const Stock& stk);
+
 // indented tree display of a stock
 void iDisplay(Stock&, int);
 
-// hash function - takes the key and returns 
-// the index in the hash table
-int key_to_index(const Stock& key, int size);
-
 // compare the company names of two Stock objects
 int compare(const Stock& b1, const Stock& b2);
 
@@ -30,6 +44,56 @@ bool isPrime(int n);
 // return the smallest prime number greater than N
 int nextPrime(int N);
 
+// parse a number in the character range [first, last) after
+// skipping leading blanks, first is moved past the number
+// return true if successful, otherwise, false
+bool parseNumber(const char*& first, const char* last, double& val);
+bool parseNumber(const char*& first, const char* last, int& val);
+
+// append a number to a string with a number of decimals, like
+// fixed and setprecision, e.g. 2 decimals for the table display
+void appendFixed(string& out, double val, int precision = 2);
+
+// append a number to a string in its shortest exact form
+void appendNumber(string& out, double val);
+void appendNumber(string& out, int val);
+
+// append a stock to a string in the DB file line format
+// without the newline, the numbers are written exactly
+void appendStockLine(string& out, const Stock& stk);
+
+// parse a date in the mm/dd/year format into the number of
+// days since 01/01/1970 (negative before), e.g. 11/12/2021
+// return true if successful, otherwise, false
+bool parseDate(string_view date, int& days);
+
+// pack a symbol and a date (days since 01/01/1970) into a 64-bit key
+// The high 48 bits hold up to 8 symbol characters of 6 bits each,
+// the low 16 bits the days since 01/01/1900, so the keys order by
+// symbol, then by date. Symbols may use A-Z, 0-9 and & - . / = ^ _
+// return 0 if the symbol or the date does not fit
+uint64_t packKey(string_view symbol, int days);
+
+// checksum of a block of memory, pass 0 to start
+// or the checksum of the previous block to continue
+uint64_t checksum(const char* data, size_t size, uint64_t h);
+
+// flush a file to the disk with fsync, e.g. before it is renamed
+// over an older copy; return true if successful, otherwise, false
+bool syncFile(const string& filename);
+
+// ask the CPU to start loading the cache line of an address that
+// is read a little later, e.g. the buckets of a batch of lookups
+// it does nothing on compilers without the builtin
+inline void prefetch(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
 // Trim a string in C++  Remove leading and trailing spaces
 string ltrim(const string& s);
 string rtrim(const string& s);
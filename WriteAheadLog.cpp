@@ -0,0 +1,329 @@
+// Implementation file for the WriteAheadLog class
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <string>
+using namespace std;
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#define fsync _commit
+#define ftruncate _chsize
+typedef long ssize_t;
+#endif
+
+#include "MappedFile.h"
+#include "Utils.h"
+#include "WriteAheadLog.h"
+
+// magic number and version at the start of a log file
+static const char WAL_MAGIC[8] = {'S', 'T', 'O', 'C', 'K', 'W', 'A', 'L'};
+static const uint32_t WAL_VERSION = 1;
+
+// size of a record header: length, checksum and type
+static const size_t RECORD_HEADER_SIZE = 4 + 4 + 1;
+
+//**************************************************
+// open the log file for appending
+// - input params: the log filename, and the DB file the
+//                 log is replayed over
+// - return true if successful, otherwise, false
+//   an existing log is kept if it has the same base file,
+//   otherwise a new empty log is started
+//   A torn or corrupted tail of a kept log is cut off, so the
+//   new records are not appended after it, where the replay
+//   would never reach them
+//**************************************************
+bool WriteAheadLog::open(const string& name, const string& baseFile)
+{
+    close();
+
+    string oldBase;
+    long long validSize = 0;
+    bool keep = readBase(name, oldBase) && oldBase == baseFile &&
+                replay(name, [](char, const char*, const char*) {}, &validSize) >= 0;
+
+    fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_APPEND | (keep ? 0 : O_TRUNC), 0644);
+    if (fd < 0) {
+        return false;
+    }
+    filename = name;
+    numRecords = 0;
+    unsynced = 0;
+    fileSize = 0;
+
+    if (keep) {
+        if (lseek(fd, 0, SEEK_END) > validSize &&
+            (ftruncate(fd, validSize) != 0 || fsync(fd) != 0)) {
+            close();
+            return false;
+        }
+        fileSize = validSize;
+    }
+    else if (!writeHeader(baseFile)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+//**************************************************
+// write the pending records, fsync and close the log
+//**************************************************
+void WriteAheadLog::close()
+{
+    if (fd >= 0) {
+        sync();
+        ::close(fd);
+        fd = -1;
+    }
+    buffer.clear();
+}
+
+//**************************************************
+// start an empty log for baseFile
+// It is called after a snapshot of the DB is saved,
+// when the records in the log are no longer needed
+// - input param: the DB file the log is replayed over
+// - return true if successful, otherwise, false
+//**************************************************
+bool WriteAheadLog::reset(const string& baseFile)
+{
+    if (fd < 0) {
+        return false;
+    }
+    buffer.clear();
+    numRecords = 0;
+    unsynced = 0;
+    if (ftruncate(fd, 0) != 0) {
+        return false;
+    }
+    fileSize = 0;
+    return writeHeader(baseFile);
+}
+
+//**************************************************
+// start a new log for baseFile with the records after offset
+// It is called when a snapshot taken in the background is
+// saved: the records before the snapshot are no longer needed,
+// the ones written while it was being saved are kept.
+// The new log is fsync-ed before it replaces the old one,
+// so a crash leaves one of the two complete logs
+// - input params: the DB file the log is replayed over, and the
+//                 size and number of records of the log when
+//                 the snapshot was taken
+// - return true if successful, otherwise, false
+//**************************************************
+bool WriteAheadLog::rotate(const string& baseFile, long long offset, long long records)
+{
+    if (fd < 0 || !sync()) {
+        return false;
+    }
+
+    // the records written after the snapshot
+    string tail;
+    if (offset < fileSize) {
+        MappedFile inFile;
+        if (!inFile.open(filename)) {
+            return false;
+        }
+        tail.assign(inFile.getData() + offset, inFile.getSize() - offset);
+    }
+
+    string tmpFile = filename + ".tmp";
+    int tmp = ::open(tmpFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (tmp < 0) {
+        return false;
+    }
+    int old = fd;
+    long long oldSize = fileSize;
+    fd = tmp;
+    fileSize = 0;
+    if (!writeHeader(baseFile) || !writeAll(tail.data(), tail.size()) || fsync(fd) != 0 ||
+        rename(tmpFile.c_str(), filename.c_str()) != 0) {
+        ::close(tmp);
+        remove(tmpFile.c_str());
+        fd = old;
+        fileSize = oldSize;
+        return false;
+    }
+    ::close(old);
+    numRecords -= records;
+    return true;
+}
+
+//**************************************************
+// append a record to the buffer
+// the record is written to the file by the next commit
+// - input params: the record type and payload
+//**************************************************
+void WriteAheadLog::append(char type, const string& payload)
+{
+    uint32_t len = static_cast<uint32_t>(payload.size());
+    uint32_t sum = static_cast<uint32_t>(checksum(payload.data(), payload.size(),
+                                                  static_cast<unsigned char>(type)));
+    char header[RECORD_HEADER_SIZE];
+    memcpy(header, &len, 4);
+    memcpy(header + 4, &sum, 4);
+    header[8] = type;
+    buffer.append(header, RECORD_HEADER_SIZE);
+    buffer.append(payload);
+    numRecords++;
+}
+
+//**************************************************
+// write the buffered records with a single write
+// and fsync if syncEvery commits have been made
+// - return true if successful, otherwise, false
+//**************************************************
+bool WriteAheadLog::commit()
+{
+    if (fd < 0) {
+        return false;
+    }
+    if (buffer.empty()) {
+        return true;
+    }
+    if (!writeAll(buffer.data(), buffer.size())) {
+        return false;
+    }
+    buffer.clear();
+
+    unsynced++;
+    if (syncEvery > 0 && unsynced >= syncEvery) {
+        unsynced = 0;
+        return fsync(fd) == 0;
+    }
+    return true;
+}
+
+//**************************************************
+// write the buffered records and fsync now
+// - return true if successful, otherwise, false
+//**************************************************
+bool WriteAheadLog::sync()
+{
+    if (fd < 0) {
+        return false;
+    }
+    if (!buffer.empty()) {
+        if (!writeAll(buffer.data(), buffer.size())) {
+            return false;
+        }
+        buffer.clear();
+    }
+    unsynced = 0;
+    return fsync(fd) == 0;
+}
+
+//**************************************************
+// read the base filename of a log file
+// - input param: the log filename
+// - return true if the file is a log, otherwise, false
+//   return the base filename via output parameter
+//**************************************************
+bool WriteAheadLog::readBase(const string& name, string& baseFile)
+{
+    MappedFile inFile;
+    if (!inFile.open(name)) {
+        return false;
+    }
+    const char* data = inFile.getData();
+    size_t size = inFile.getSize();
+
+    uint32_t version, len;
+    if (size < sizeof(WAL_MAGIC) + 8 || memcmp(data, WAL_MAGIC, sizeof(WAL_MAGIC)) != 0) {
+        return false;
+    }
+    memcpy(&version, data + sizeof(WAL_MAGIC), 4);
+    memcpy(&len, data + sizeof(WAL_MAGIC) + 4, 4);
+    if (version != WAL_VERSION || size < sizeof(WAL_MAGIC) + 8 + len) {
+        return false;
+    }
+    baseFile.assign(data + sizeof(WAL_MAGIC) + 8, len);
+    return true;
+}
+
+//**************************************************
+// call the replay function for each valid record of a log file
+// The replay stops at the first torn or corrupted record,
+// which is where the writer crashed
+// - input params: the log filename, and the replay function
+// - return the number of records replayed, or -1 if the
+//   file is not a log
+//   return the size of the file up to the end of the last
+//   valid record via output parameter, if not NULL
+//**************************************************
+long long WriteAheadLog::replay(const string& name, const ReplayFunc& replay,
+                                long long* validSize)
+{
+    MappedFile inFile;
+    string baseFile;
+    if (!readBase(name, baseFile) || !inFile.open(name)) {
+        return -1;
+    }
+    const char* p = inFile.getData() + sizeof(WAL_MAGIC) + 8 + baseFile.size();
+    const char* end = inFile.getData() + inFile.getSize();
+
+    long long n = 0;
+    while (static_cast<size_t>(end - p) >= RECORD_HEADER_SIZE) {
+        uint32_t len, sum;
+        memcpy(&len, p, 4);
+        memcpy(&sum, p + 4, 4);
+        char type = p[8];
+        const char* payload = p + RECORD_HEADER_SIZE;
+        if (static_cast<size_t>(end - payload) < len ||
+            sum != static_cast<uint32_t>(checksum(payload, len, static_cast<unsigned char>(type)))) {
+            break;
+        }
+        replay(type, payload, payload + len);
+        n++;
+        p = payload + len;
+    }
+    if (validSize) {
+        *validSize = p - inFile.getData();
+    }
+    return n;
+}
+
+//**************************************************
+// write the file header for baseFile
+// - input param: the DB file the log is replayed over
+// - return true if successful, otherwise, false
+//**************************************************
+bool WriteAheadLog::writeHeader(const string& baseFile)
+{
+    string header(WAL_MAGIC, sizeof(WAL_MAGIC));
+    uint32_t len = static_cast<uint32_t>(baseFile.size());
+    header.append(reinterpret_cast<const char*>(&WAL_VERSION), 4);
+    header.append(reinterpret_cast<const char*>(&len), 4);
+    header.append(baseFile);
+    return writeAll(header.data(), header.size()) && fsync(fd) == 0;
+}
+
+//**************************************************
+// write a buffer to the file
+// - input params: the buffer and its size
+// - return true if successful, otherwise, false
+//**************************************************
+bool WriteAheadLog::writeAll(const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+        fileSize += n;
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+// Specification file for the WriteAheadLog class
+// WriteAheadLog is an append-only log of the changes made to the
+// stock database since the last snapshot. Each change is appended
+// to an in-memory buffer as a checksummed record, and commit()
+// writes all the buffered records with a single write, so all the
+// records of one operation reach the file together (group commit).
+// The file is fsync-ed every syncEvery commits.
+//
+// File layout:
+//   magic "STOCKWAL", version, length of the base filename,
+//   the base filename (the DB file the log is replayed over),
+//   then the records: length, checksum, type, payload
+
+#ifndef WRITE_AHEAD_LOG_H_
+#define WRITE_AHEAD_LOG_H_
+
+#include <string>
+#include <functional>
+#include <cstdint>
+using std::string;
+
+class WriteAheadLog
+{
+public:
+    // record types
+    static const char ADD_RECORD = 'A';       // payload: a DB file line
+    static const char DELETE_RECORD = 'D';    // payload: symbol;date
+    static const char UNDO_RECORD = 'U';      // payload: a DB file line
+
+    // the function called for each record during replay
+    typedef std::function<void(char type, const char* first, const char* last)> ReplayFunc;
+
+private:
+    int fd;             // file descriptor of the log, -1 if closed
+    string filename;    // name of the log file
+    string buffer;      // records not yet written
+    int syncEvery;      // fsync every syncEvery commits, 0 for never
+    int unsynced;       // commits since the last fsync
+    long long numRecords;   // records appended since open or reset
+    long long fileSize;     // bytes written to the file
+
+public:
+    // constructor and destructor
+    WriteAheadLog() {fd = -1; syncEvery = 1; unsynced = 0; numRecords = 0; fileSize = 0;}
+    ~WriteAheadLog() {close();}
+
+    // setters
+    void setSyncEvery(int n) {syncEvery = n;}
+
+    // getters
+    int getSyncEvery() const {return syncEvery;}
+    bool isOpen() const {return fd >= 0;}
+    long long getNumRecords() const {return numRecords;}
+    long long getSize() const {return fileSize;}
+    const string& getFilename() const {return filename;}
+
+    // open the log file for appending
+    // a new or empty log is started for baseFile
+    bool open(const string& name, const string& baseFile);
+
+    // write the pending records, fsync and close the log
+    void close();
+
+    // start an empty log for baseFile, e.g. after a snapshot
+    bool reset(const string& baseFile);
+
+    // start a new log for baseFile that keeps the records written
+    // after offset, e.g. after a snapshot taken when the log was
+    // offset bytes and numRecords records long; the new log is
+    // written to a temporary file and renamed over the old one
+    bool rotate(const string& baseFile, long long offset, long long records);
+
+    // append a record to the buffer
+    void append(char type, const string& payload);
+
+    // write the buffered records and fsync if it is due
+    bool commit();
+
+    // write the buffered records and fsync now
+    bool sync();
+
+    // read the base filename of a log file
+    // return false if the file does not exist or is not a log
+    static bool readBase(const string& name, string& baseFile);
+
+    // call replay for each valid record of a log file and
+    // return the number of records, stop at the first torn
+    // or corrupted record; the size of the file up to the end
+    // of the last valid record is returned via validSize
+    static long long replay(const string& name, const ReplayFunc& replay,
+                            long long* validSize = NULL);
+
+private:
+    // write the file header for baseFile at the start of the file
+    bool writeHeader(const string& baseFile);
+
+    // write a buffer to the file
+    bool writeAll(const char* data, size_t size);
+
+    // not copyable
+    WriteAheadLog(const WriteAheadLog&);
+    WriteAheadLog& operator=(const WriteAheadLog&);
+};
+
+#endif // WRITE_AHEAD_LOG_H_
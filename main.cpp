@@ -1,25 +1,148 @@
 // Stock Database main file main.cpp
 
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 using namespace std;
 
 #include "StockDB.h"
+#include "Benchmark.h"
+#include "BatchRunner.h"
+#include "StockServer.h"
+#include "LoadClient.h"
 
 int main(int argc, char* argv[])
 {
     if (argc < 2) {
         cout << "Stock DB input filename is needed in the command line argument." << endl;
+        cout << "Usage: " << argv[0] << " filename [--threads N] [--no-wal] [--wal-sync N]"
+             << " [--script file [--out file]]"
+             << " [--serve socket] [--page N]"
+             << " [--save-order key|company|hash]" << endl;
+        cout << "       " << argv[0] << " --bench name [N]" << endl;
+        cout << "       " << argv[0] << " --client socket script [connections] [depth]" << endl;
+        return 0;
+    }
+
+    // run the load generator of the server mode
+    if (strcmp(argv[1], "--client") == 0) {
+        if (argc < 4) {
+            cout << "Socket path and script file are needed" << endl;
+            return 0;
+        }
+        int connections = (argc > 4) ? atoi(argv[4]) : 1;
+        int depth = (argc > 5) ? atoi(argv[5]) : 16;
+        LoadClient client(argv[2], connections, depth);
+        if (client.loadScript(argv[3])) {
+            client.run();
+            client.showStats(cout);
+        }
+        return 0;
+    }
+
+    // run a benchmark instead of the main menu
+    if (strcmp(argv[1], "--bench") == 0) {
+        if (argc < 3) {
+            cout << "Benchmark name is needed: wal, hash, rehash, tree, alloc, pool, scan, screen, readers, save, display, mget, top, indicators" << endl;
+            return 0;
+        }
+        int n = (argc > 3) ? atoi(argv[3]) : 0;
+        if (!runBenchmark(argv[2], n)) {
+            cout << "Unknown benchmark " << argv[2] << endl;
+        }
         return 0;
     }
 
     // get the Stock DB input filename
     string filename = argv[1];
 
+    // get the options
+    // --threads N : parse the input file, sort and format the saved
+    //               files, and search large batches of lookups,
+    //               on N threads (0 for all cores)
+    // --no-wal : do not log the changes to the write-ahead log
+    // --wal-sync N : fsync the write-ahead log every N changes (0 for never)
+    // --script file : run the commands of a script instead of the menu
+    // --out file : write the results of the script to a file
+    // --serve socket : serve requests on a Unix domain socket instead of the menu
+    // --page N : show the sorted table N rows at a time (0 for all)
+    // --save-order key|company|hash : the order of the stocks in the saved files
+    int numThreads = 1;
+    int pageSize = 0;
+    bool walEnabled = true;
+    int walSync = 1;
+    string scriptFile, outFile, socketPath;
+    string saveOrder = "key";
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--no-wal") == 0) {
+            walEnabled = false;
+        }
+        else if (strcmp(argv[i], "--wal-sync") == 0 && i + 1 < argc) {
+            walSync = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            scriptFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--page") == 0 && i + 1 < argc) {
+            pageSize = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--save-order") == 0 && i + 1 < argc) {
+            saveOrder = argv[++i];
+        }
+        else {
+            cout << "Unknown option " << argv[i] << endl;
+            return 0;
+        }
+    }
+
     // create a StockDB, load DB, and run main menu
     StockDB stockDB;
-    if (stockDB.loadDB(filename)) {
+    stockDB.setLogEnabled(walEnabled);
+    stockDB.setLogSync(walSync);
+    stockDB.setPageSize(pageSize);
+    stockDB.setSaveThreads(numThreads);
+    stockDB.setSearchThreads(numThreads);
+    if (!stockDB.setSaveOrder(saveOrder)) {
+        cout << "Unknown save order " << saveOrder << ", it is key, company or hash" << endl;
+        return 0;
+    }
+    if (stockDB.loadDB(filename, numThreads)) {
         cout << "Stock database " << filename << " loaded." << endl; 
-        stockDB.mainMenu();
+        if (!socketPath.empty()) {
+            // serve requests until stopped by a signal
+            StockServer server(stockDB);
+            if (server.run(socketPath)) {
+                server.showStats(cout);
+            }
+        }
+        else if (scriptFile.empty()) {
+            stockDB.mainMenu();
+        }
+        else {
+            // run the script, the results go to the output file or cout
+            ofstream results;
+            if (!outFile.empty()) {
+                results.open(outFile);
+                if (!results) {
+                    cout << "Error opening the output file: \"" << outFile << "\"" << endl;
+                    return 0;
+                }
+            }
+            BatchRunner runner(stockDB, outFile.empty() ? cout : results);
+            if (runner.runFile(scriptFile)) {
+                runner.showStats(cout);
+            }
+        }
     }
     else {
         cout << "Failed to load Stock database " << filename << endl;
@@ -27,4 +150,3 @@ int main(int argc, char* argv[])
     
     return 0;
 }
-